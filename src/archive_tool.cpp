@@ -0,0 +1,128 @@
+// --- Game Archive Tool ---
+// Lists the games of a match archive and exports them as the JieqiBox JSON
+// notation files the arena used to write for every game.
+//
+// Build with `make archive`, then run:
+//   ./jieqi_archive list <match.jqa>                        (one line per game)
+//   ./jieqi_archive show <match.jqa> <game_id>              (JSON of one game to stdout)
+//   ./jieqi_archive export <match.jqa> <dir> [game_id...]   (game_<id>.json files, all by default)
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "game_archive.hpp"
+
+namespace {
+
+bool open_archive(const std::string &path, GameArchiveReader &archive) {
+    std::string error;
+    if (!archive.open(path, error)) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Entry of `game_id` in the archive; reports an error if there is none.
+std::optional<size_t> find_game(const GameArchiveReader &archive, const std::string &game_id) {
+    std::optional<size_t> entry;
+    try {
+        entry = archive.find(std::stoll(game_id));
+    } catch (const std::exception &) {
+    }
+    if (!entry) std::cerr << "No game " << game_id << " in the archive" << std::endl;
+    return entry;
+}
+
+int list(const std::string &path) {
+    GameArchiveReader archive;
+    if (!open_archive(path, archive)) return 1;
+
+    GameRecord record;
+    std::string error;
+    for (size_t i = 0; i < archive.size(); ++i) {
+        if (!archive.read(i, record, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << std::format("{:>7}  {:<7}  {} - {}  {} moves  {}\n", record.game_id,
+                                 record.result, record.red_name, record.black_name,
+                                 record.moves.size(), record.date);
+    }
+    std::cout << std::format("{} games.\n", archive.size());
+    return 0;
+}
+
+int show(const std::string &path, const std::string &game_id) {
+    GameArchiveReader archive;
+    if (!open_archive(path, archive)) return 1;
+    std::optional<size_t> entry = find_game(archive, game_id);
+    if (!entry) return 1;
+
+    GameRecord record;
+    std::string error;
+    if (!archive.read(*entry, record, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    write_jieqibox_json(std::cout, record);
+    return 0;
+}
+
+int export_games(const std::string &path, const std::string &directory,
+                 const std::vector<std::string> &game_ids) {
+    GameArchiveReader archive;
+    if (!open_archive(path, archive)) return 1;
+
+    std::vector<size_t> entries;
+    if (game_ids.empty()) {
+        for (size_t i = 0; i < archive.size(); ++i) entries.push_back(i);
+    }
+    for (const std::string &game_id : game_ids) {
+        std::optional<size_t> entry = find_game(archive, game_id);
+        if (!entry) return 1;
+        entries.push_back(*entry);
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    GameRecord record;
+    std::string error;
+    for (size_t entry : entries) {
+        if (!archive.read(entry, record, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::string filename = std::format("{}/game_{}.json", directory, record.game_id);
+        std::ofstream ofs(filename, std::ios::out | std::ios::trunc);
+        write_jieqibox_json(ofs, record);
+        if (!ofs) {
+            std::cerr << "Failed writing " << filename << std::endl;
+            return 1;
+        }
+    }
+    std::cout << std::format("Exported {} games to {}.\n", entries.size(), directory);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() == 2 && args[0] == "list") return list(args[1]);
+    if (args.size() == 3 && args[0] == "show") return show(args[1], args[2]);
+    if (args.size() >= 3 && args[0] == "export") {
+        return export_games(args[1], args[2], {args.begin() + 3, args.end()});
+    }
+
+    std::cerr << "Usage:\n"
+                 "  jieqi_archive list <match.jqa>\n"
+                 "  jieqi_archive show <match.jqa> <game_id>\n"
+                 "  jieqi_archive export <match.jqa> <dir> [game_id...]\n";
+    return 2;
+}
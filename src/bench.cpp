@@ -0,0 +1,275 @@
+// --- Move Validator Benchmark ---
+// Perft-style legal move counts through MoveValidator over a suite of Jieqi
+// positions, a correctness cross-check of the move generator, and
+// microbenchmarks of the adjudication hot paths.
+//
+// Build with `make bench`, then run:
+//   ./jieqi_bench [depth]        (default depth 4)
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.hpp"
+#include "engine.hpp"
+#include "game.hpp"
+#include "logger.hpp"
+#include "move_validator.hpp"
+#include "piece_pool.hpp"
+#include "types.hpp"
+#include "uci_info.hpp"
+
+// Referenced by Game::run(); never set here.
+std::atomic<bool> g_stop_match(false);
+
+namespace {
+
+constexpr int MAX_CHECKED_DEPTH = 4;
+
+struct BenchPosition {
+    std::string_view fen;
+    // Expected perft node counts for depths 1..MAX_CHECKED_DEPTH.
+    std::array<std::uint64_t, MAX_CHECKED_DEPTH> perft;
+};
+
+// Hidden pieces that move are revealed as the role of their starting square,
+// so the counts below are deterministic. With every piece revealed this way,
+// the start position reproduces the standard Xiangqi perft numbers.
+constexpr BenchPosition BENCH_POSITIONS[] = {
+    {"xxxxkxxxx/9/1x5x1/x1x1x1x1x/9/9/X1X1X1X1X/1X5X1/9/XXXXKXXXX w R2r2N2n2B2b2A2a2C2c2P5p5 0 1",
+     {44, 1920, 79666, 3290240}},
+    {"xxxxkxxxx/1p7/7x1/x3x1x1x/9/n7P/2x1x1x2/2B4x1/9/xxxxKxxxx w R2r2A2a2C2c2N1n1B1b2P4p4 0 1",
+     {34, 1172, 39770, 1300196}},
+    {"1x2kx1Px/4n4/b2ap3a/x1x1x1x1x/9/6N1p/xPxCx3x/P5R2/9/x2xKxx1x w R1r1A2C1c2N1n1B2b1P2p3 0 1",
+     {38, 757, 29671, 616752}},
+    {"3xk1xxx/p3a4/4p4/x5x1x/2r1n4/A1C6/x3x1x1p/6R2/1n3K2B/xxx1rxxx1 w R1a1C1c2N2B1b2P4p2 0 1",
+     {30, 1225, 35027, 1455235}},
+    {"xx1xkx3/7Pc/p1p3n1p/x5x1x/4br3/1R6N/2x1x3x/P1P3P2/8A/C1xxK1x2 w r1A1a2C1c1N1n1B2b1P1p1 0 1",
+     {36, 933, 30863, 834245}},
+    {"r1cx1kxx1/4r4/1B2pbn1p/4xNBax/5Rp2/3R2P2/pAx6/6P1N/P3A4/3xKxx2 w a1C2c1n1b1P2p1 0 1",
+     {42, 1233, 49405, 1495359}},
+    {"3ank3/9/p7p/Pr1a2x2/2b1P4/1p4P1C/3C5/A8/P3P1R2/1N1K1x3 w A1c1 0 1", {40, 791, 31107, 687651}},
+};
+
+Color opposite(Color c) {
+    return c == Color::RED ? Color::BLACK : Color::RED;
+}
+
+// Sets up the board and side to move from a FEN string.
+Color load_position(std::string_view fen, Board &board) {
+    board.set_fen_board(fen.substr(0, fen.find(' ')));
+    return fen.substr(fen.find(' ') + 1, 1) == "w" ? Color::RED : Color::BLACK;
+}
+
+void make(Board &board, const Move &m, Piece &moving, Piece &captured) {
+    moving = board.piece_at(m.from);
+    captured = board.make_move(m.from, m.to);
+    if (moving == Piece::HIDDEN) board.put_piece(m.to, MoveValidator::hidden_role(m.from));
+}
+
+void unmake(Board &board, const Move &m, Piece moving, Piece captured) {
+    board.unmake_move(m.from, m.to, captured);
+    if (moving == Piece::HIDDEN) board.put_piece(m.from, Piece::HIDDEN);
+}
+
+std::uint64_t perft(const MoveValidator &validator, Board &board, Color side, int depth) {
+    MoveList moves = validator.generate_legal_moves(side, board);
+    if (depth == 1) return moves.size();
+
+    std::uint64_t nodes = 0;
+    for (const Move &m : moves) {
+        Piece moving, captured;
+        make(board, m, moving, captured);
+        nodes += perft(validator, board, opposite(side), depth - 1);
+        unmake(board, m, moving, captured);
+    }
+    return nodes;
+}
+
+// Cross-checks the generator against a brute-force scan of every square pair
+// through is_move_legal(), and has_legal_move()/is_checkmate_or_stalemate()
+// against the generated list, at every node up to `depth`.
+// Returns the number of disagreements.
+int verify(const MoveValidator &validator, Board &board, Color side, int depth) {
+    MoveList moves = validator.generate_legal_moves(side, board);
+
+    std::array<bool, BOARD_SQUARES * BOARD_SQUARES> generated{};
+    for (const Move &m : moves) generated[m.from * BOARD_SQUARES + m.to] = true;
+
+    int errors = 0;
+    for (int from = 0; from < BOARD_SQUARES; ++from) {
+        for (int to = 0; to < BOARD_SQUARES; ++to) {
+            std::string uci = square_name(from) + square_name(to);
+            bool expected = generated[from * BOARD_SQUARES + to];
+            if (validator.is_move_legal(uci, side, board) != expected) {
+                std::cout << std::format("  mismatch on {} in {}\n", uci, board.fen_board());
+                errors++;
+            }
+        }
+    }
+    if (validator.has_legal_move(side, board) == moves.empty() ||
+        validator.is_checkmate_or_stalemate(side, board) != moves.empty()) {
+        std::cout << std::format("  mate/stalemate mismatch in {}\n", board.fen_board());
+        errors++;
+    }
+
+    if (depth > 1) {
+        for (const Move &m : moves) {
+            Piece moving, captured;
+            make(board, m, moving, captured);
+            errors += verify(validator, board, opposite(side), depth - 1);
+            unmake(board, m, moving, captured);
+        }
+    }
+    return errors;
+}
+
+// Runs `op` repeatedly for roughly `budget` and returns nanoseconds per call.
+template <typename Op>
+double time_per_op(Op &&op, std::chrono::milliseconds budget = std::chrono::milliseconds(300)) {
+    using clock = std::chrono::steady_clock;
+    long long calls = 0;
+    auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    while (elapsed < budget) {
+        for (int i = 0; i < 64; ++i) calls += op();
+        elapsed = clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(calls);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    LoggerConfig::set_enabled(false);
+    int depth = argc > 1 ? std::stoi(argv[1]) : 4;
+
+    MoveValidator validator;
+    int failures = 0;
+
+    // --- Perft ---
+    std::cout << std::format("Perft to depth {} over {} positions\n", depth,
+                             std::size(BENCH_POSITIONS));
+    std::uint64_t total_nodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &pos : BENCH_POSITIONS) {
+        Board board;
+        Color side = load_position(pos.fen, board);
+        std::uint64_t nodes = perft(validator, board, side, depth);
+        total_nodes += nodes;
+
+        std::string status;
+        if (depth <= MAX_CHECKED_DEPTH) {
+            bool ok = nodes == pos.perft[depth - 1];
+            status = ok ? "ok" : std::format("FAIL (expected {})", pos.perft[depth - 1]);
+            failures += !ok;
+        }
+        std::cout << std::format("{:>12} {} {}\n", nodes, pos.fen, status);
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::format("Nodes searched: {}\n", total_nodes);
+    std::cout << std::format("Nodes/second  : {:.0f}\n\n", total_nodes / seconds);
+
+    // --- Generator cross-check ---
+    int errors = 0;
+    for (const auto &pos : BENCH_POSITIONS) {
+        Board board;
+        Color side = load_position(pos.fen, board);
+        errors += verify(validator, board, side, 2);
+    }
+    std::cout << std::format("Generator cross-check (depth 2): {}\n\n",
+                             errors == 0 ? "ok" : std::format("{} mismatches", errors));
+    failures += errors;
+
+    // --- Microbenchmarks ---
+    std::vector<Board> boards;
+    std::vector<Color> sides;
+    std::vector<std::pair<std::size_t, std::string>> legal_moves;  // (board index, UCI move)
+    for (const auto &pos : BENCH_POSITIONS) {
+        Board board;
+        sides.push_back(load_position(pos.fen, board));
+        for (const Move &m : validator.generate_legal_moves(sides.back(), board)) {
+            legal_moves.emplace_back(boards.size(), m.to_uci());
+        }
+        boards.push_back(board);
+    }
+
+    // Results are accumulated into `sink` so that no call can be optimized away.
+    std::size_t next = 0, sink = 0;
+    double in_check_ns = time_per_op([&] {
+        next = (next + 1) % boards.size();
+        sink += validator.is_in_check(sides[next], boards[next]);
+        return 1;
+    });
+    double move_legal_ns = time_per_op([&] {
+        next = (next + 1) % legal_moves.size();
+        const auto &[index, uci] = legal_moves[next];
+        sink += validator.is_move_legal(uci, sides[index], boards[index]);
+        return 1;
+    });
+    double mate_ns = time_per_op([&] {
+        next = (next + 1) % boards.size();
+        sink += validator.is_checkmate_or_stalemate(sides[next], boards[next]);
+        return 1;
+    });
+
+    Engine red("Red"), black("Black");
+    Game game(red, black, BENCH_POSITIONS[0].fen);
+    double parse_fen_ns = time_per_op([&] {
+        next = (next + 1) % std::size(BENCH_POSITIONS);
+        game.parse_fen(BENCH_POSITIONS[next].fen);
+        return 1;
+    });
+    double generate_fen_ns = time_per_op([&] {
+        sink += game.generate_fen().size();
+        return 1;
+    });
+
+    // Draws both sides' pools empty, refilling them from a pool string every
+    // 30 draws; the refill is included in the time.
+    PiecePool pool;
+    pool.from_string("R2r2A2a2C2c2N2n2B2b2P5p5");
+    int draws = 0;
+    double draw_ns = time_per_op([&] {
+        Color side = (draws++ % 2) ? Color::RED : Color::BLACK;
+        std::optional<Piece> drawn = pool.draw_random_piece(side);
+        if (!drawn) {
+            pool.from_string("R2r2A2a2C2c2N2n2B2b2P5p5");
+            return 0;
+        }
+        sink += static_cast<std::size_t>(*drawn);
+        return 1;
+    });
+
+    constexpr std::string_view INFO_LINES[] = {
+        "info depth 18 seldepth 27 multipv 1 score cp 35 nodes 4210339 nps 1403446 hashfull 412 "
+        "tbhits 0 time 3000 pv h2e2 h9g7 h0g2 i9h9 i0h0 b9c7 b0c2 a9b9",
+        "info depth 21 seldepth 30 score mate -7 upperbound nodes 9120331 nps 1520055 time 6000",
+        "info depth 19 currmove b0c2 currmovenumber 4",
+    };
+    double parse_info_ns = time_per_op([&] {
+        next = (next + 1) % std::size(INFO_LINES);
+        SearchInfo info;
+        sink += parse_info_line(INFO_LINES[next], info) + info.pv.size();
+        return 1;
+    });
+
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "is_in_check", in_check_ns);
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "is_move_legal", move_legal_ns);
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "is_checkmate_or_stalemate", mate_ns);
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "Game::parse_fen", parse_fen_ns);
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "Game::generate_fen", generate_fen_ns);
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "PiecePool draw", draw_ns);
+    std::cout << std::format("{:<26} {:>10.1f} ns/op\n", "parse_info_line", parse_info_ns);
+    std::cout << std::format("(checksum {})\n", sink);
+
+    return failures == 0 ? 0 : 1;
+}
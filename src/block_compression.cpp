@@ -0,0 +1,110 @@
+#include "block_compression.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+// The hash table remembers the last position of each 4-byte hash.
+constexpr int HASH_BITS = 15;
+constexpr std::uint32_t NO_POSITION = UINT32_MAX;
+
+void put_varint(std::string &out, size_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+bool get_varint(std::string_view &in, size_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && !in.empty(); shift += 7) {
+        auto byte = static_cast<unsigned char>(in.front());
+        in.remove_prefix(1);
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+std::uint32_t load32(const char *p) {
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash4(std::uint32_t bytes) {
+    return (bytes * 2654435761u) >> (32 - HASH_BITS);
+}
+
+}  // namespace
+
+std::string compress_block(std::string_view raw) {
+    std::string out;
+    out.reserve(raw.size() / 2 + 16);
+    std::vector<std::uint32_t> table(size_t{1} << HASH_BITS, NO_POSITION);
+    const char *data = raw.data();
+    size_t literal_start = 0, pos = 0;
+
+    while (pos + MIN_MATCH <= raw.size()) {
+        std::uint32_t &slot = table[hash4(load32(data + pos))];
+        std::uint32_t candidate = slot;
+        slot = static_cast<std::uint32_t>(pos);
+        if (candidate == NO_POSITION || load32(data + candidate) != load32(data + pos)) {
+            ++pos;
+            continue;
+        }
+
+        size_t length = MIN_MATCH;
+        while (pos + length < raw.size() && data[candidate + length] == data[pos + length]) {
+            ++length;
+        }
+        put_varint(out, pos - literal_start);
+        out.append(data + literal_start, pos - literal_start);
+        put_varint(out, length - MIN_MATCH);
+        put_varint(out, pos - candidate);
+
+        // Remember the positions inside the match, so that the next record
+        // can refer to any part of it.
+        size_t end = pos + length;
+        for (++pos; pos < end && pos + MIN_MATCH <= raw.size(); ++pos) {
+            table[hash4(load32(data + pos))] = static_cast<std::uint32_t>(pos);
+        }
+        pos = end;
+        literal_start = end;
+    }
+
+    put_varint(out, raw.size() - literal_start);
+    out.append(data + literal_start, raw.size() - literal_start);
+    return out;
+}
+
+bool decompress_block(std::string_view compressed, size_t raw_size, std::string &raw) {
+    raw.clear();
+    raw.reserve(raw_size);
+    while (true) {
+        size_t literals;
+        if (!get_varint(compressed, literals) || literals > compressed.size() ||
+            literals > raw_size - raw.size()) {
+            return false;
+        }
+        raw.append(compressed.data(), literals);
+        compressed.remove_prefix(literals);
+        if (raw.size() == raw_size) return compressed.empty();
+
+        size_t length, distance;
+        if (!get_varint(compressed, length) || !get_varint(compressed, distance)) return false;
+        length += MIN_MATCH;
+        if (distance == 0 || distance > raw.size() || length > raw_size - raw.size()) {
+            return false;
+        }
+        // Byte by byte: a match may overlap the bytes it produces.
+        size_t start = raw.size();
+        raw.resize(start + length);
+        char *out = raw.data();
+        for (size_t i = 0; i < length; ++i) out[start + i] = out[start - distance + i];
+    }
+}
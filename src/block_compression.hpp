@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// --- Block Compression ---
+// A small LZ77 compressor for archive blocks. Game records repeat the same
+// FEN prefixes, engine names and field layouts over and over, so plain
+// back-references shrink them several times over without any external
+// library. The encoding is a sequence of
+//   literal count (varint), literal bytes, match length - 4 (varint), distance (varint)
+// where the last sequence has literals only and ends at the block's raw size.
+
+std::string compress_block(std::string_view raw);
+
+// Expands `compressed` into `raw`, which must come out `raw_size` bytes long.
+// Returns false if the input is corrupt.
+bool decompress_block(std::string_view compressed, size_t raw_size, std::string &raw);
@@ -0,0 +1,123 @@
+#include "board.hpp"
+
+#include <cctype>
+#include <stdexcept>
+
+#include "zobrist.hpp"
+
+int parse_square(std::string_view coord) {
+    if (coord.length() != 2) return NO_SQUARE;
+    int col = coord[0] - 'a';
+    int row = 9 - (coord[1] - '0');
+    if (row < 0 || row > 9 || col < 0 || col > 8) return NO_SQUARE;
+    return make_square(row, col);
+}
+
+std::string square_name(int sq) {
+    return {static_cast<char>('a' + square_col(sq)), static_cast<char>('0' + 9 - square_row(sq))};
+}
+
+Board::Board() {
+    clear();
+}
+
+void Board::clear() {
+    squares.fill(Piece::EMPTY);
+    by_piece.fill(0);
+    by_color.fill(0);
+    occupied_bb = 0;
+    hash_key = 0;
+}
+
+void Board::put_piece(int sq, Piece p) {
+    Piece old = squares[sq];
+    Bitboard bb = square_bb(sq);
+    if (old != Piece::EMPTY) {
+        by_piece[static_cast<int>(old)] &= ~bb;
+        by_color[0] &= ~bb;
+        by_color[1] &= ~bb;
+        occupied_bb &= ~bb;
+        hash_key ^= ZOBRIST.piece_square[static_cast<int>(old)][sq];
+    }
+    squares[sq] = p;
+    if (p != Piece::EMPTY) {
+        Color c = (p == Piece::HIDDEN) ? hidden_owner(sq) : piece_color(p);
+        by_piece[static_cast<int>(p)] |= bb;
+        by_color[color_index(c)] |= bb;
+        occupied_bb |= bb;
+        hash_key ^= ZOBRIST.piece_square[static_cast<int>(p)][sq];
+    }
+}
+
+Piece Board::make_move(int from, int to) {
+    Piece moving = squares[from];
+    Piece captured = squares[to];
+    put_piece(to, moving);
+    put_piece(from, Piece::EMPTY);
+    return captured;
+}
+
+void Board::unmake_move(int from, int to, Piece captured) {
+    put_piece(from, squares[to]);
+    put_piece(to, captured);
+}
+
+int Board::king_square(Color c) const {
+    Bitboard kings = pieces(c == Color::RED ? Piece::RED_KING : Piece::BLK_KING);
+    return kings ? lsb(kings) : NO_SQUARE;
+}
+
+Color Board::owner(int sq) const {
+    Piece p = squares[sq];
+    if (p == Piece::EMPTY) return Color::NONE;
+    return p == Piece::HIDDEN ? hidden_owner(sq) : piece_color(p);
+}
+
+void Board::set_fen_board(std::string_view board_part) {
+    clear();
+    int row = 0, col = 0;
+    for (char c : board_part) {
+        if (c == '/') {
+            row++;
+            col = 0;
+        } else if (isdigit(c)) {
+            col += c - '0';
+        } else {
+            Piece piece = char_to_piece(c);
+            if (piece == Piece::EMPTY) {
+                throw std::runtime_error("Invalid FEN string: unknown piece character.");
+            }
+            if (col < BOARD_COLS && row < BOARD_ROWS) {
+                put_piece(make_square(row, col), piece);
+                col++;
+            }
+        }
+    }
+}
+
+std::string Board::fen_board() const {
+    std::string fen;
+    fen.reserve(BOARD_SQUARES + BOARD_ROWS);
+    for (int r = 0; r < BOARD_ROWS; ++r) {
+        int empty_count = 0;
+        for (int c = 0; c < BOARD_COLS; ++c) {
+            Piece p = piece_at(r, c);
+            if (p == Piece::EMPTY) {
+                empty_count++;
+            } else {
+                if (empty_count > 0) {
+                    fen += static_cast<char>('0' + empty_count);
+                    empty_count = 0;
+                }
+                fen += piece_to_char(p);
+            }
+        }
+        if (empty_count > 0) {
+            fen += static_cast<char>('0' + empty_count);
+        }
+        if (r < BOARD_ROWS - 1) {
+            fen += '/';
+        }
+    }
+    return fen;
+}
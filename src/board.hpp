@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "types.hpp"
+
+// --- Board Representation ---
+// A flat 90-square mailbox plus 128-bit occupancy bitboards per piece type and
+// per color. Squares are numbered row by row from Black's back rank:
+// square = row * 9 + col, where row 0 is rank 9 and col 0 is file 'a'.
+
+constexpr int BOARD_ROWS = 10;
+constexpr int BOARD_COLS = 9;
+constexpr int BOARD_SQUARES = BOARD_ROWS * BOARD_COLS;
+constexpr int NO_SQUARE = -1;
+
+// One bit per square; only the low 90 bits are used.
+using Bitboard = unsigned __int128;
+
+constexpr int make_square(int row, int col) { return row * BOARD_COLS + col; }
+constexpr int square_row(int sq) { return sq / BOARD_COLS; }
+constexpr int square_col(int sq) { return sq % BOARD_COLS; }
+constexpr Bitboard square_bb(int sq) { return Bitboard(1) << sq; }
+
+inline int popcount(Bitboard b) {
+    return __builtin_popcountll(static_cast<unsigned long long>(b)) +
+           __builtin_popcountll(static_cast<unsigned long long>(b >> 64));
+}
+
+// Index of the least significant set bit. `b` must not be empty.
+inline int lsb(Bitboard b) {
+    auto low = static_cast<unsigned long long>(b);
+    return low ? __builtin_ctzll(low)
+               : 64 + __builtin_ctzll(static_cast<unsigned long long>(b >> 64));
+}
+
+// Removes and returns the least significant set bit. `b` must not be empty.
+inline int pop_lsb(Bitboard &b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+// Converts a coordinate such as "e0" to a square, or NO_SQUARE if invalid.
+int parse_square(std::string_view coord);
+
+// Converts a square back to its coordinate (e.g. "e0").
+std::string square_name(int sq);
+
+class Board {
+   private:
+    std::array<Piece, BOARD_SQUARES> squares;
+    std::array<Bitboard, static_cast<int>(Piece::EMPTY)> by_piece{};  // Indexed by Piece
+    std::array<Bitboard, 2> by_color{};  // Revealed and hidden pieces, by owner
+    Bitboard occupied_bb = 0;
+    std::uint64_t hash_key = 0;  // Zobrist key of the pieces on the board
+
+    static int color_index(Color c) { return c == Color::RED ? 0 : 1; }
+
+   public:
+    Board();
+
+    // Removes all pieces.
+    void clear();
+
+    Piece piece_at(int sq) const { return squares[sq]; }
+    Piece piece_at(int row, int col) const { return squares[make_square(row, col)]; }
+
+    // Places `p` on `sq`, replacing whatever was there. EMPTY clears the square.
+    void put_piece(int sq, Piece p);
+    void remove_piece(int sq) { put_piece(sq, Piece::EMPTY); }
+
+    // Moves the piece on `from` to `to` in place and returns the captured piece
+    // (EMPTY if none). The moving piece keeps its identity; revealing a hidden
+    // piece is done separately with put_piece().
+    Piece make_move(int from, int to);
+    // Reverts make_move() given the piece it returned.
+    void unmake_move(int from, int to, Piece captured);
+
+    Bitboard occupied() const { return occupied_bb; }
+    Bitboard pieces(Piece p) const { return by_piece[static_cast<int>(p)]; }
+    Bitboard pieces(Color c) const { return by_color[color_index(c)]; }
+
+    // Zobrist key of the piece placement, maintained incrementally.
+    std::uint64_t key() const { return hash_key; }
+
+    // Square of the given king, or NO_SQUARE if it has been captured.
+    int king_square(Color c) const;
+
+    // Owner of the piece on `sq`, including hidden pieces. NONE if empty.
+    Color owner(int sq) const;
+
+    // Hidden pieces never move without being revealed, so their owner follows
+    // from the half of the board they start on.
+    static Color hidden_owner(int sq) { return square_row(sq) > 4 ? Color::RED : Color::BLACK; }
+
+    // Sets up the board from the first field of a FEN string.
+    // Throws std::runtime_error on malformed input.
+    void set_fen_board(std::string_view board_part);
+
+    // Generates the first field of a FEN string.
+    std::string fen_board() const;
+};
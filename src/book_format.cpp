@@ -0,0 +1,202 @@
+#include "book_format.hpp"
+
+#include <format>
+
+#include "move_validator.hpp"
+
+namespace {
+
+// Pieces of each kind one side starts with, by POOL_PIECES modulo 6.
+constexpr std::array<int, 6> PIECE_SET = {2, 2, 2, 2, 2, 5};
+
+// Order of the pool in a FEN, as written by PiecePool::to_string().
+constexpr std::array<Piece, 12> FEN_POOL_ORDER = {
+    Piece::RED_ROOK,   Piece::BLK_ROOK,   Piece::RED_ADVISOR, Piece::BLK_ADVISOR,
+    Piece::RED_CANNON, Piece::BLK_CANNON, Piece::RED_KNIGHT,  Piece::BLK_KNIGHT,
+    Piece::RED_BISHOP, Piece::BLK_BISHOP, Piece::RED_PAWN,    Piece::BLK_PAWN};
+
+int pool_slot(Piece p) {
+    for (size_t i = 0; i < POOL_PIECES.size(); ++i) {
+        if (POOL_PIECES[i] == p) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool in_palace(int sq, Color side) {
+    int row = square_row(sq), col = square_col(sq);
+    bool palace_rows = side == Color::RED ? row >= 7 : row <= 2;
+    return palace_rows && col >= 3 && col <= 5;
+}
+
+// Splits off the text up to the next space (or the end) and the space itself.
+std::string_view next_field(std::string_view &rest) {
+    size_t end = rest.find(' ');
+    std::string_view field = rest.substr(0, end);
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+    return field;
+}
+
+}  // namespace
+
+bool book_record_in_range(const BookRecord &record) {
+    if (record.side_to_move > 1) return false;
+    for (size_t slot = 0; slot < POOL_PIECES.size(); ++slot) {
+        if (record.pool[slot] > PIECE_SET[slot % 6]) return false;
+    }
+    return true;
+}
+
+std::optional<BookRecord> encode_book_record(std::string_view fen, std::string &error) {
+    auto fail = [&error](std::string message) -> std::optional<BookRecord> {
+        error = std::move(message);
+        return std::nullopt;
+    };
+
+    while (!fen.empty() && (fen.back() == '\r' || fen.back() == ' ')) fen.remove_suffix(1);
+    while (!fen.empty() && fen.front() == ' ') fen.remove_prefix(1);
+    std::string_view rest = fen;
+    std::string_view board_field = next_field(rest);
+    std::string_view side_field = next_field(rest);
+    // An empty pool leaves two spaces in a row; move counters may follow.
+    std::string_view pool_field = next_field(rest);
+
+    // --- Board ---
+    Board board;
+    int row = 0, col = 0;
+    for (char c : board_field) {
+        if (c == '/') {
+            if (col != BOARD_COLS) return fail(std::format("rank {} has {} files", 9 - row, col));
+            if (++row >= BOARD_ROWS) return fail("board has more than 10 ranks");
+            col = 0;
+        } else if (c >= '1' && c <= '9') {
+            col += c - '0';
+        } else {
+            Piece piece = char_to_piece(c);
+            if (piece == Piece::EMPTY) return fail(std::format("unknown piece character '{}'", c));
+            if (col >= BOARD_COLS) return fail(std::format("rank {} is too long", 9 - row));
+            board.put_piece(make_square(row, col), piece);
+            col++;
+        }
+        if (col > BOARD_COLS) return fail(std::format("rank {} is too long", 9 - row));
+    }
+    if (row != BOARD_ROWS - 1 || col != BOARD_COLS) {
+        return fail("board does not have 10 ranks of 9 files");
+    }
+
+    // --- Side to move ---
+    if (side_field != "w" && side_field != "b") {
+        return fail(std::format("side to move '{}' is not 'w' or 'b'", side_field));
+    }
+    Color side = side_field == "w" ? Color::RED : Color::BLACK;
+
+    // --- Kings ---
+    for (Color c : {Color::RED, Color::BLACK}) {
+        Piece king = c == Color::RED ? Piece::RED_KING : Piece::BLK_KING;
+        const char *name = c == Color::RED ? "Red" : "Black";
+        if (popcount(board.pieces(king)) != 1) return fail(std::format("{} needs one king", name));
+        if (!in_palace(lsb(board.pieces(king)), c)) {
+            return fail(std::format("{} king is outside its palace", name));
+        }
+    }
+
+    // --- Hidden pieces ---
+    std::array<int, 2> hidden{};  // By color
+    for (Bitboard b = board.pieces(Piece::HIDDEN); b;) {
+        int sq = pop_lsb(b);
+        Piece role = MoveValidator::hidden_role(sq);
+        if (role == Piece::EMPTY || role == Piece::RED_KING || role == Piece::BLK_KING) {
+            return fail(std::format("hidden piece on {}, which is not a starting square",
+                                    square_name(sq)));
+        }
+        hidden[Board::hidden_owner(sq) == Color::RED ? 0 : 1]++;
+    }
+
+    // --- Pool ---
+    BookRecord record;
+    std::array<bool, 12> listed{};
+    if (pool_field.size() % 2 != 0) return fail(std::format("malformed pool '{}'", pool_field));
+    for (size_t i = 0; i < pool_field.size(); i += 2) {
+        int slot = pool_slot(char_to_piece(pool_field[i]));
+        char count = pool_field[i + 1];
+        if (slot < 0 || count < '0' || count > '9') {
+            return fail(std::format("malformed pool entry '{}'", pool_field.substr(i, 2)));
+        }
+        if (listed[slot]) {
+            return fail(std::format("pool lists '{}' twice", pool_field[i]));
+        }
+        listed[slot] = true;
+        record.pool[slot] = static_cast<std::uint8_t>(count - '0');
+    }
+
+    std::array<int, 2> pooled{};
+    for (size_t slot = 0; slot < POOL_PIECES.size(); ++slot) {
+        Piece piece = POOL_PIECES[slot];
+        int total = popcount(board.pieces(piece)) + record.pool[slot];
+        if (total > PIECE_SET[slot % 6]) {
+            return fail(std::format("{} '{}' on the board and in the pool, at most {} allowed",
+                                    total, piece_to_char(piece), PIECE_SET[slot % 6]));
+        }
+        pooled[slot < 6 ? 0 : 1] += record.pool[slot];
+    }
+    for (int c = 0; c < 2; ++c) {
+        if (hidden[c] != pooled[c]) {
+            return fail(std::format("{} has {} hidden pieces but {} in the pool",
+                                    c == 0 ? "Red" : "Black", hidden[c], pooled[c]));
+        }
+    }
+
+    // --- Legality ---
+    MoveValidator validator;
+    Color opponent = side == Color::RED ? Color::BLACK : Color::RED;
+    if (validator.is_in_check(opponent, board)) {
+        return fail("the side not to move is in check");
+    }
+    if (!validator.has_legal_move(side, board)) {
+        return fail("the side to move has no legal move");
+    }
+
+    for (int sq = 0; sq < BOARD_SQUARES; ++sq) {
+        auto nibble = static_cast<std::uint8_t>(board.piece_at(sq));
+        record.board[sq / 2] |= static_cast<std::uint8_t>(nibble << (sq % 2 * 4));
+    }
+    record.side_to_move = side == Color::RED ? 0 : 1;
+    return record;
+}
+
+std::string book_record_fen(const BookRecord &record) {
+    std::string fen;
+    fen.reserve(128);
+    for (int row = 0; row < BOARD_ROWS; ++row) {
+        if (row > 0) fen += '/';
+        int empty_count = 0;
+        for (int col = 0; col < BOARD_COLS; ++col) {
+            int sq = make_square(row, col);
+            Piece p = record.piece_at(sq);
+            if (p == Piece::EMPTY) {
+                empty_count++;
+                continue;
+            }
+            if (empty_count > 0) {
+                fen += static_cast<char>('0' + empty_count);
+                empty_count = 0;
+            }
+            if (p == Piece::HIDDEN) {
+                fen += Board::hidden_owner(sq) == Color::RED ? 'X' : 'x';
+            } else {
+                fen += piece_to_char(p);
+            }
+        }
+        if (empty_count > 0) fen += static_cast<char>('0' + empty_count);
+    }
+
+    fen += record.turn() == Color::RED ? " w " : " b ";
+    for (Piece piece : FEN_POOL_ORDER) {
+        int count = record.pool[pool_slot(piece)];
+        if (count > 0) {
+            fen += piece_to_char(piece);
+            fen += static_cast<char>('0' + count);
+        }
+    }
+    fen += " 0 1";
+    return fen;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "board.hpp"
+#include "types.hpp"
+
+// --- Binary Opening Book ---
+// A book file is a BookFileHeader followed by fixed-size BookRecords, one per
+// position. Records are validated once when the book is converted from FENs
+// (see book_tool.cpp), so the arena loads them straight into the board and
+// piece pool without parsing anything, after a cheap range check that guards
+// against truncated or hand-edited files.
+
+// The pieces a pool can hold, in the order of BookRecord::pool.
+constexpr std::array<Piece, 12> POOL_PIECES = {
+    Piece::RED_ADVISOR, Piece::RED_BISHOP, Piece::RED_KNIGHT, Piece::RED_ROOK,
+    Piece::RED_CANNON,  Piece::RED_PAWN,   Piece::BLK_ADVISOR, Piece::BLK_BISHOP,
+    Piece::BLK_KNIGHT,  Piece::BLK_ROOK,   Piece::BLK_CANNON,  Piece::BLK_PAWN};
+
+struct BookRecord {
+    // Piece values of the 90 squares, two per byte, the even square in the low nibble.
+    std::array<std::uint8_t, BOARD_SQUARES / 2> board{};
+    std::uint8_t side_to_move = 0;        // 0 for Red, 1 for Black
+    std::array<std::uint8_t, 12> pool{};  // Unrevealed pieces, by POOL_PIECES
+    std::array<std::uint8_t, 6> reserved{};
+
+    Piece piece_at(int sq) const {
+        return static_cast<Piece>((board[sq / 2] >> (sq % 2 * 4)) & 0xF);
+    }
+    Color turn() const { return side_to_move == 0 ? Color::RED : Color::BLACK; }
+};
+static_assert(sizeof(BookRecord) == 64);
+static_assert(static_cast<int>(Piece::EMPTY) < 16, "pieces must fit in a nibble");
+
+struct BookFileHeader {
+    char magic[8];
+    std::uint32_t record_size;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(BookFileHeader) == 16);
+
+constexpr char BOOK_MAGIC[8] = {'J', 'Q', 'B', 'O', 'O', 'K', '0', '1'};
+
+// Parses a FEN and checks that it is a position a game can start from: a
+// well-formed 10x9 board, one king per side inside its palace, hidden pieces
+// only on their starting squares, a pool that matches the hidden pieces and
+// does not exceed the piece set, the side not to move not in check and the
+// side to move with a legal move. Returns nullopt with `error` set otherwise.
+std::optional<BookRecord> encode_book_record(std::string_view fen, std::string &error);
+
+// Whether a record read from a file or the network can be loaded without
+// indexing out of range: a known side to move and pool counts within the
+// piece set. Board nibbles always name a Piece. This is not the full check of
+// encode_book_record(); it only keeps a damaged record from corrupting memory.
+bool book_record_in_range(const BookRecord &record);
+
+// The FEN of a record, with hidden Red pieces written as 'X'.
+std::string book_record_fen(const BookRecord &record);
@@ -0,0 +1,148 @@
+// --- Opening Book Tool ---
+// Validates FEN books and converts them to the binary book format, so that
+// malformed positions are rejected once, before any match uses the book.
+//
+// Build with `make book`, then run:
+//   ./jieqi_book convert <book.fen> <book.jqb>   (drops and reports invalid lines)
+//   ./jieqi_book check <book.fen>                (exits non-zero if any line is invalid)
+//   ./jieqi_book dump <book.jqb>                 (prints the FEN of every record)
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "book_format.hpp"
+#include "mapped_file.hpp"
+#include "opening_book.hpp"
+
+namespace {
+
+// Invalid lines reported in full; beyond that only the total is printed.
+constexpr int MAX_REPORTED_ERRORS = 50;
+
+struct ValidationSummary {
+    size_t valid = 0;
+    size_t invalid = 0;
+};
+
+// Validates every non-blank line of `path` and hands the records of the valid
+// ones to `consume`. Returns false if the file cannot be read.
+template <typename Consume>
+bool validate_book(const std::string &path, ValidationSummary &summary, Consume &&consume) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::string_view rest = file.view();
+    std::string error;
+    for (size_t line_number = 1; !rest.empty(); ++line_number) {
+        size_t end = rest.find('\n');
+        std::string_view line = rest.substr(0, end);
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+
+        if (std::optional<BookRecord> record = encode_book_record(line, error)) {
+            summary.valid++;
+            consume(*record);
+        } else {
+            if (static_cast<int>(summary.invalid) < MAX_REPORTED_ERRORS) {
+                std::cerr << std::format("{}:{}: {}\n", path, line_number, error);
+            }
+            summary.invalid++;
+        }
+    }
+    if (static_cast<int>(summary.invalid) > MAX_REPORTED_ERRORS) {
+        std::cerr << std::format("... {} more invalid lines\n",
+                                 summary.invalid - MAX_REPORTED_ERRORS);
+    }
+    return true;
+}
+
+int convert(const std::string &input, const std::string &output) {
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Cannot create " << output << std::endl;
+        return 1;
+    }
+    BookFileHeader header{};
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.record_size = sizeof(BookRecord);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<BookRecord> buffer;
+    buffer.reserve(4096);
+    auto flush = [&] {
+        out.write(reinterpret_cast<const char *>(buffer.data()),
+                  static_cast<std::streamsize>(buffer.size() * sizeof(BookRecord)));
+        buffer.clear();
+    };
+
+    ValidationSummary summary;
+    bool readable = validate_book(input, summary, [&](const BookRecord &record) {
+        buffer.push_back(record);
+        if (buffer.size() == buffer.capacity()) flush();
+    });
+    flush();
+    out.close();
+    if (!readable) return 1;
+    if (!out) {
+        std::cerr << "Failed writing " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << std::format("Wrote {} positions to {} ({} invalid lines skipped).\n",
+                             summary.valid, output, summary.invalid);
+    return 0;
+}
+
+int check(const std::string &input) {
+    ValidationSummary summary;
+    if (!validate_book(input, summary, [](const BookRecord &) {})) return 1;
+    std::cout << std::format("{} valid positions, {} invalid lines.\n", summary.valid,
+                             summary.invalid);
+    return summary.invalid == 0 ? 0 : 1;
+}
+
+int dump(const std::string &input) {
+    OpeningBook book;
+    std::string error;
+    if (!book.open(input, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (!book.is_binary()) {
+        std::cerr << input << " is not a binary book" << std::endl;
+        return 1;
+    }
+    size_t damaged = 0;
+    for (size_t i = 0; i < book.size(); ++i) {
+        if (!book_record_in_range(book.record(i))) {
+            std::cerr << "Record " << i << " is damaged" << std::endl;
+            damaged++;
+            continue;
+        }
+        std::cout << book_record_fen(book.record(i)) << '\n';
+    }
+    return damaged == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() == 3 && args[0] == "convert") return convert(args[1], args[2]);
+    if (args.size() == 2 && args[0] == "check") return check(args[1]);
+    if (args.size() == 2 && args[0] == "dump") return dump(args[1]);
+
+    std::cerr << "Usage:\n"
+                 "  jieqi_book convert <book.fen> <book.jqb>\n"
+                 "  jieqi_book check <book.fen>\n"
+                 "  jieqi_book dump <book.jqb>\n";
+    return 2;
+}
@@ -0,0 +1,79 @@
+#include "cpu_affinity.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <map>
+#include <utility>
+
+#ifdef __linux__
+#include <sched.h>
+
+namespace {
+
+// Reads an integer from a sysfs topology file, or returns `fallback`.
+int read_topology_value(int cpu, const char *file, int fallback) {
+    std::ifstream in(std::format("/sys/devices/system/cpu/cpu{}/topology/{}", cpu, file));
+    int value;
+    return (in >> value) ? value : fallback;
+}
+
+}  // namespace
+#endif
+
+std::vector<CpuSet> detect_physical_cores() {
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return {};
+    }
+
+    // Logical CPUs sharing (package, core) are SMT siblings of one physical
+    // core. A CPU without topology information counts as a core of its own.
+    std::map<std::pair<int, int>, CpuSet> by_core;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        int package = read_topology_value(cpu, "physical_package_id", -1 - cpu);
+        int core = read_topology_value(cpu, "core_id", cpu);
+        by_core[{package, core}].push_back(cpu);
+    }
+
+    std::vector<CpuSet> cores;
+    for (auto &[id, cpus] : by_core) {
+        cores.push_back(std::move(cpus));
+    }
+    // Keep the natural CPU order, so that consecutive slots get nearby cores.
+    std::sort(cores.begin(), cores.end());
+    return cores;
+#else
+    return {};
+#endif
+}
+
+std::vector<SlotAffinity> plan_affinity(const std::vector<CpuSet> &cores, int slot_count,
+                                        int cores_per_game) {
+    std::vector<SlotAffinity> plan;
+    if (cores.empty()) {
+        return plan;
+    }
+
+    size_t next_core = 0;
+    for (int slot = 0; slot < slot_count; ++slot) {
+        SlotAffinity affinity;
+        // Both engines get the same number of cores. An odd core left over
+        // stays reserved for the slot but runs neither engine.
+        int engine_cores = cores_per_game >= 2 ? cores_per_game / 2 : cores_per_game;
+        for (int i = 0; i < cores_per_game; ++i) {
+            const CpuSet &core = cores[next_core++ % cores.size()];
+            if (i < engine_cores) {
+                affinity.engine1.insert(affinity.engine1.end(), core.begin(), core.end());
+            }
+            if ((i >= engine_cores && i < 2 * engine_cores) || cores_per_game == 1) {
+                affinity.engine2.insert(affinity.engine2.end(), core.begin(), core.end());
+            }
+        }
+        plan.push_back(std::move(affinity));
+    }
+    return plan;
+}
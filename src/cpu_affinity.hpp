@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+// --- CPU Affinity ---
+// Pins engine processes to dedicated physical cores, so that the engines of
+// concurrent games neither migrate between cores nor share a core (or its SMT
+// siblings) with each other. Linux only; elsewhere no cores are detected and
+// nothing is pinned.
+
+// Logical CPUs an engine process may run on. Empty means no pinning.
+using CpuSet = std::vector<int>;
+
+// Core sets of the two engines of one game slot. Each set belongs to an
+// engine of the match (not to a color), so that a pooled engine process keeps
+// its cores when it switches colors.
+struct SlotAffinity {
+    CpuSet engine1;
+    CpuSet engine2;
+};
+
+// Returns the physical cores this process may use, each as the list of its
+// logical CPUs (SMT siblings). Empty if the topology cannot be determined.
+std::vector<CpuSet> detect_physical_cores();
+
+// Hands out `cores_per_game` physical cores to each of `slot_count` game
+// slots, in order, wrapping around if there are not enough cores. With two or
+// more cores per game, each engine of the slot gets cores_per_game / 2 cores
+// of its own, and an odd last core is left idle so that neither engine gets
+// more than the other; with one, both engines share the core (only one of
+// them searches at a time).
+std::vector<SlotAffinity> plan_affinity(const std::vector<CpuSet> &cores, int slot_count,
+                                        int cores_per_game);
@@ -0,0 +1,722 @@
+#include "distributed.hpp"
+
+#ifdef __linux__
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+#include "protocol.hpp"
+
+extern std::atomic<bool> g_stop_match;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest time the coordinator sleeps before checking whether the match was stopped.
+constexpr int STOP_CHECK_MS = 100;
+// How long a worker node waits for each line of the coordinator's greeting.
+constexpr int HANDSHAKE_TIMEOUT_MS = 10000;
+
+// --- Sockets ---
+
+// Opens a listening or connected stream socket for a "unix:<path>" or
+// "tcp:<host>:<port>" address. Returns -1 with `error` set on failure.
+int open_socket(const std::string &address, bool listening, std::string &error) {
+    if (address.starts_with("unix:")) {
+        std::string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            error = std::format("Invalid socket path in {}", address);
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        int fd =
+            socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | (listening ? SOCK_NONBLOCK : 0), 0);
+        if (fd == -1) {
+            error = std::format("socket failed: {}", std::strerror(errno));
+            return -1;
+        }
+        if (listening) unlink(path.c_str());
+        auto *sa = reinterpret_cast<const sockaddr *>(&addr);
+        bool ok = listening ? bind(fd, sa, sizeof(addr)) == 0 && listen(fd, 64) == 0
+                            : connect(fd, sa, sizeof(addr)) == 0;
+        if (!ok) {
+            error = std::format("Cannot {} {}: {}", listening ? "listen on" : "connect to",
+                                address, std::strerror(errno));
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    std::string host_port = address.starts_with("tcp:") ? address.substr(4) : address;
+    size_t colon = host_port.rfind(':');
+    if (colon == std::string::npos) {
+        error = std::format("Invalid address {}; expected unix:<path> or tcp:<host>:<port>",
+                            address);
+        return -1;
+    }
+    std::string host = host_port.substr(0, colon);
+    std::string port = host_port.substr(colon + 1);
+    if (host == "*") host.clear();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    addrinfo *results = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints,
+                             &results);
+    if (status != 0) {
+        error = std::format("Cannot resolve {}: {}", address, gai_strerror(status));
+        return -1;
+    }
+
+    int fd = -1;
+    error = std::format("Cannot {} {}", listening ? "listen on" : "connect to", address);
+    for (addrinfo *ai = results; ai && fd == -1; ai = ai->ai_next) {
+        fd = socket(ai->ai_family,
+                    ai->ai_socktype | SOCK_CLOEXEC | (listening ? SOCK_NONBLOCK : 0),
+                    ai->ai_protocol);
+        if (fd == -1) continue;
+        int one = 1;
+        bool ok;
+        if (listening) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            ok = bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, 64) == 0;
+        } else {
+            ok = connect(fd, ai->ai_addr, ai->ai_addrlen) == 0;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        if (!ok) {
+            error = std::format("Cannot {} {}: {}", listening ? "listen on" : "connect to",
+                                address, std::strerror(errno));
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(results);
+    return fd;
+}
+
+// --- Message Fields ---
+
+std::vector<std::string_view> split_fields(std::string_view line) {
+    std::vector<std::string_view> fields;
+    while (true) {
+        size_t tab = line.find('\t');
+        fields.push_back(line.substr(0, tab));
+        if (tab == std::string_view::npos) return fields;
+        line.remove_prefix(tab + 1);
+    }
+}
+
+// A field value with the separators replaced by spaces.
+std::string field(std::string_view value) {
+    std::string out(value);
+    std::replace_if(
+        out.begin(), out.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return out;
+}
+
+template <typename T>
+bool parse_number(std::string_view s, T &value) {
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    return ec == std::errc() && end == s.data() + s.size();
+}
+
+std::string to_hex(std::string_view bytes) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        out += DIGITS[c >> 4];
+        out += DIGITS[c & 0xF];
+    }
+    return out;
+}
+
+bool from_hex(std::string_view hex, std::string &bytes) {
+    if (hex.size() % 2 != 0) return false;
+    auto digit = [](char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    bytes.clear();
+    bytes.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int high = digit(hex[i]), low = digit(hex[i + 1]);
+        if (high < 0 || low < 0) return false;
+        bytes += static_cast<char>(high << 4 | low);
+    }
+    return true;
+}
+
+std::string encode_task(int slot, const GameTask &task) {
+    std::string record;
+    if (task.start_record) {
+        record = to_hex(std::string_view(reinterpret_cast<const char *>(&*task.start_record),
+                                         sizeof(BookRecord)));
+    }
+    return std::format("task\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}", slot, task.game_id,
+                       task.pairing, task.red_is_first ? 1 : 0, task.flip_key,
+                       field(task.red_engine_path), field(task.black_engine_path),
+                       field(task.red_engine_options), field(task.black_engine_options),
+                       field(task.start_fen), record);
+}
+
+bool decode_task(const std::vector<std::string_view> &fields, int &slot, GameTask &task) {
+    int red_is_first = 0;
+    if (fields.size() != 12 || !parse_number(fields[1], slot) ||
+        !parse_number(fields[2], task.game_id) || !parse_number(fields[3], task.pairing) ||
+        !parse_number(fields[4], red_is_first) || !parse_number(fields[5], task.flip_key)) {
+        return false;
+    }
+    task.red_is_first = red_is_first != 0;
+    task.red_engine_path = fields[6];
+    task.black_engine_path = fields[7];
+    task.red_engine_options = fields[8];
+    task.black_engine_options = fields[9];
+    task.start_fen = fields[10];
+    task.start_record.reset();
+    if (!fields[11].empty()) {
+        std::string bytes;
+        if (!from_hex(fields[11], bytes) || bytes.size() != sizeof(BookRecord)) return false;
+        BookRecord record;
+        std::memcpy(&record, bytes.data(), sizeof(record));
+        if (!book_record_in_range(record)) return false;
+        task.start_record = record;
+    }
+    return true;
+}
+
+char result_code(Color result) {
+    return result == Color::RED ? 'R' : result == Color::BLACK ? 'B' : 'N';
+}
+
+Color result_from_code(std::string_view code) {
+    return code == "R" ? Color::RED : code == "B" ? Color::BLACK : Color::NONE;
+}
+
+// --- Coordinator ---
+
+class Coordinator {
+   private:
+    struct Node {
+        int fd = -1;
+        std::string name;
+        std::string input;
+        std::string output;  // Not yet sent
+        bool joined = false;
+        bool dropped = false;
+        std::vector<int> slots;  // Coordinator slot of each of the node's slots
+        std::vector<int> games;  // Game in play on each slot, 0 if idle
+        Clock::time_point last_heard;
+        Clock::time_point last_ping;
+    };
+
+    struct Lease {
+        GameTask task;
+        Node *node;
+    };
+
+    const CoordinatorConfig &config;
+    int ping_ms;
+    int listen_fd = -1;
+    int next_node_id = 1;
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<bool> slot_taken;
+    std::unordered_map<int, Lease> leases;  // Games in play, by id
+    std::deque<GameTask> requeued;          // Games of dropped nodes
+    bool drained = false;                   // The match has no new games left
+
+    void accept_nodes();
+    void receive(Node &node);
+    void flush(Node &node);
+    void handle(Node &node, std::string_view line);
+    void join(Node &node, const std::vector<std::string_view> &fields);
+    void dispatch();
+    void drop(Node &node, const std::string &reason);
+    void broadcast(const std::string &line);
+
+   public:
+    explicit Coordinator(const CoordinatorConfig &config)
+        : config(config),
+          ping_ms(std::max(config.lease_ms / 4, 1)),
+          slot_taken(std::max(config.slots, 1)) {}
+    ~Coordinator();
+
+    void run();
+};
+
+Coordinator::~Coordinator() {
+    for (auto &node : nodes) {
+        if (node->fd != -1) close(node->fd);
+    }
+    if (listen_fd != -1) {
+        close(listen_fd);
+        if (config.address.starts_with("unix:")) unlink(config.address.substr(5).c_str());
+    }
+}
+
+void Coordinator::accept_nodes() {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) return;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        auto node = std::make_unique<Node>();
+        node->fd = fd;
+        node->name = std::format("node {}", next_node_id++);
+        node->last_heard = node->last_ping = Clock::now();
+        nodes.push_back(std::move(node));
+    }
+}
+
+void Coordinator::receive(Node &node) {
+    char buffer[65536];
+    while (!node.dropped) {
+        ssize_t n = recv(node.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            node.input.append(buffer, n);
+            node.last_heard = Clock::now();
+            continue;
+        }
+        if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n == -1 && errno == EINTR) continue;
+        drop(node, "connection closed");
+        return;
+    }
+
+    size_t start = 0, end;
+    while (!node.dropped && (end = node.input.find('\n', start)) != std::string::npos) {
+        handle(node, std::string_view(node.input).substr(start, end - start));
+        start = end + 1;
+    }
+    node.input.erase(0, start);
+}
+
+void Coordinator::flush(Node &node) {
+    while (!node.output.empty() && !node.dropped) {
+        ssize_t n = send(node.fd, node.output.data(), node.output.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            node.output.erase(0, n);
+        } else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else if (n == -1 && errno != EINTR) {
+            drop(node, "connection closed");
+        }
+    }
+}
+
+void Coordinator::handle(Node &node, std::string_view line) {
+    std::vector<std::string_view> fields = split_fields(line);
+    std::string_view command = fields[0];
+
+    if (!node.joined) {
+        if (command == "hello") {
+            join(node, fields);
+        } else {
+            drop(node, "no greeting");
+        }
+        return;
+    }
+
+    if (command == "record") {
+        std::string bytes;
+        GameRecord record;
+        if (fields.size() != 2 || !from_hex(fields[1], bytes) ||
+            !decode_game_record(bytes, record)) {
+            drop(node, "malformed record");
+            return;
+        }
+        // Only the node holding the lease may archive the game.
+        auto it = leases.find(record.game_id);
+        if (it == leases.end() || it->second.node != &node) return;
+        record.seed = config.seed;
+        save_game_record(std::move(record));
+    } else if (command == "result") {
+        int game_id = 0;
+        if (fields.size() != 3 || !parse_number(fields[1], game_id)) {
+            drop(node, "malformed result");
+            return;
+        }
+        auto it = leases.find(game_id);
+        if (it == leases.end() || it->second.node != &node) return;
+        GameTask task = std::move(it->second.task);
+        leases.erase(it);
+        std::replace(node.games.begin(), node.games.end(), game_id, 0);
+        record_game_result(task, result_from_code(fields[2]));
+    }
+    // "ping" only renews the lease, like any other message.
+}
+
+void Coordinator::join(Node &node, const std::vector<std::string_view> &fields) {
+    int version = 0, wanted = 0;
+    if (fields.size() != 3 || !parse_number(fields[1], version) ||
+        !parse_number(fields[2], wanted) || version != DISTRIBUTED_PROTOCOL_VERSION) {
+        drop(node, "unsupported protocol");
+        return;
+    }
+    for (int slot = 0; slot < static_cast<int>(slot_taken.size()); ++slot) {
+        if (static_cast<int>(node.slots.size()) == wanted) break;
+        if (slot_taken[slot]) continue;
+        slot_taken[slot] = true;
+        node.slots.push_back(slot);
+    }
+    node.games.assign(node.slots.size(), 0);
+    if (node.slots.empty()) {
+        node.output += "done\n";
+        send_info_string(
+            std::format("Worker node {} turned away: all {} game slot(s) are in use.", node.name,
+                        slot_taken.size()));
+        return;
+    }
+
+    for (const auto &[name, value] : config.options) {
+        node.output += std::format("option\t{}\t{}\n", field(name), field(value));
+    }
+    node.output += std::format("start\t{}\t{}\t{}\n", node.slots.size(), ping_ms, config.seed);
+    node.joined = true;
+    send_info_string(
+        std::format("Worker node {} joined with {} game slot(s).", node.name, node.slots.size()));
+}
+
+void Coordinator::dispatch() {
+    for (auto &node : nodes) {
+        if (!node->joined || node->dropped) continue;
+        for (size_t i = 0; i < node->slots.size(); ++i) {
+            if (node->games[i] != 0) continue;
+            GameTask task;
+            if (!requeued.empty()) {
+                task = std::move(requeued.front());
+                requeued.pop_front();
+            } else if (!next_game_task(node->slots[i], task)) {
+                drained = true;
+                continue;
+            }
+            node->games[i] = task.game_id;
+            node->output += encode_task(static_cast<int>(i), task) + '\n';
+            send_info_string(std::format("Starting Game {} on {} slot {}", task.game_id,
+                                         node->name, i));
+            leases.insert_or_assign(task.game_id, Lease{std::move(task), node.get()});
+        }
+    }
+}
+
+void Coordinator::drop(Node &node, const std::string &reason) {
+    if (node.dropped) return;
+    node.dropped = true;
+    int handed_back = 0;
+    for (size_t i = 0; i < node.slots.size(); ++i) {
+        if (node.games[i] != 0) {
+            auto it = leases.find(node.games[i]);
+            if (it != leases.end()) {
+                requeued.push_back(std::move(it->second.task));
+                leases.erase(it);
+                handed_back++;
+            }
+        }
+        // The second game of the slot's round is not bound to the node either.
+        GameTask task;
+        if (take_unplayed_game(node.slots[i], task)) {
+            requeued.push_back(std::move(task));
+            handed_back++;
+        }
+        slot_taken[node.slots[i]] = false;
+    }
+    close(node.fd);
+    node.fd = -1;
+    if (node.joined) {
+        send_info_string(std::format("Worker node {} dropped ({}); {} game(s) handed to others.",
+                                     node.name, reason, handed_back));
+    }
+}
+
+void Coordinator::broadcast(const std::string &line) {
+    for (auto &node : nodes) {
+        if (!node->joined || node->dropped) continue;
+        node->output += line;
+        node->output += '\n';
+        // Best effort: the nodes notice a closed connection anyway.
+        flush(*node);
+    }
+}
+
+void Coordinator::run() {
+    std::string error;
+    listen_fd = open_socket(config.address, true, error);
+    if (listen_fd == -1) {
+        send_info_string(std::format("Error: {}. No games are played.", error));
+        return;
+    }
+    send_info_string(std::format("Waiting for worker nodes on {} ({} game slot(s)).",
+                                 config.address, slot_taken.size()));
+
+    std::vector<pollfd> fds;
+    while (true) {
+        if (g_stop_match) {
+            broadcast("stop");
+            return;
+        }
+        dispatch();
+        if (drained && leases.empty() && requeued.empty()) {
+            broadcast("done");
+            return;
+        }
+
+        fds.clear();
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (auto &node : nodes) {
+            short events = POLLIN | (node->output.empty() ? 0 : POLLOUT);
+            fds.push_back({node->fd, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), std::min(STOP_CHECK_MS, ping_ms)) < 0 &&
+            errno != EINTR) {
+            send_info_string("Error: poll failed, coordinator stopped.");
+            return;
+        }
+
+        for (size_t i = 1; i < fds.size(); ++i) {
+            Node &node = *nodes[i - 1];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) receive(node);
+            flush(node);
+        }
+        if (fds[0].revents & POLLIN) accept_nodes();
+
+        auto now = Clock::now();
+        for (auto &node : nodes) {
+            if (node->dropped) continue;
+            if (now - node->last_heard > std::chrono::milliseconds(config.lease_ms)) {
+                drop(*node, "lease expired");
+            } else if (node->joined &&
+                       now - node->last_ping >= std::chrono::milliseconds(ping_ms)) {
+                node->output += "ping\n";
+                node->last_ping = now;
+            }
+        }
+        std::erase_if(nodes, [](const auto &node) { return node->dropped; });
+    }
+}
+
+}  // namespace
+
+bool distributed_supported() {
+    return true;
+}
+
+void run_coordinator(const CoordinatorConfig &config) {
+    Coordinator coordinator(config);
+    coordinator.run();
+}
+
+// --- CoordinatorLink ---
+
+CoordinatorLink::~CoordinatorLink() {
+    if (fd != -1) close(fd);
+}
+
+bool CoordinatorLink::connect(const std::string &address, int slots, std::string &error) {
+    fd = open_socket(address, false, error);
+    if (fd == -1) return false;
+    if (!send_line(std::format("hello\t{}\t{}", DISTRIBUTED_PROTOCOL_VERSION, slots))) {
+        error = "Connection closed";
+        return false;
+    }
+
+    std::string line;
+    bool closed = false;
+    while (read_line(line, HANDSHAKE_TIMEOUT_MS, closed)) {
+        std::vector<std::string_view> fields = split_fields(line);
+        if (fields[0] == "option" && fields.size() == 3) {
+            options_.emplace_back(fields[1], fields[2]);
+        } else if (fields[0] == "start" && fields.size() == 4 &&
+                   parse_number(fields[1], slots_) && parse_number(fields[2], ping_ms) &&
+                   parse_number(fields[3], seed_)) {
+            tasks.resize(slots_);
+            return true;
+        } else if (fields[0] == "done") {
+            error = "The coordinator has no free game slots";
+            return false;
+        }
+    }
+    error = closed ? "Connection closed" : "No answer from the coordinator";
+    return false;
+}
+
+bool CoordinatorLink::run() {
+    auto last_heard = Clock::now();
+    auto last_ping = last_heard;
+    // The coordinator pings every ping_ms and drops nodes silent for four times as long.
+    auto silence_limit = std::chrono::milliseconds(4 * ping_ms);
+    std::string line;
+    while (true) {
+        bool closed = false;
+        bool got_line = read_line(line, ping_ms, closed);
+        auto now = Clock::now();
+        if (closed || (!got_line && now - last_heard > silence_limit)) {
+            finish();
+            return false;
+        }
+        if (now - last_ping >= std::chrono::milliseconds(ping_ms)) {
+            if (!send_line("ping")) {
+                finish();
+                return false;
+            }
+            last_ping = now;
+        }
+        if (!got_line) continue;
+        last_heard = now;
+
+        std::vector<std::string_view> fields = split_fields(line);
+        if (fields[0] == "task") {
+            int slot = 0;
+            GameTask task;
+            if (!decode_task(fields, slot, task) || slot < 0 || slot >= slots_) continue;
+            {
+                std::lock_guard<std::mutex> lock(task_mutex);
+                tasks[slot].push_back(std::move(task));
+            }
+            task_ready.notify_all();
+        } else if (fields[0] == "done") {
+            finish();
+            return true;
+        } else if (fields[0] == "stop") {
+            finish();
+            return false;
+        }
+    }
+}
+
+bool CoordinatorLink::next_task(int slot, GameTask &task) {
+    std::unique_lock<std::mutex> lock(task_mutex);
+    task_ready.wait(lock, [&] { return finished || !tasks[slot].empty(); });
+    if (tasks[slot].empty()) return false;
+    task = std::move(tasks[slot].front());
+    tasks[slot].pop_front();
+    return true;
+}
+
+void CoordinatorLink::report_result(int game_id, Color result) {
+    send_line(std::format("result\t{}\t{}", game_id, result_code(result)));
+}
+
+void CoordinatorLink::report_record(const GameRecord &record) {
+    std::string bytes;
+    encode_game_record(record, bytes);
+    send_line("record\t" + to_hex(bytes));
+}
+
+bool CoordinatorLink::send_line(const std::string &line) {
+    std::lock_guard<std::mutex> lock(send_mutex);
+    std::string data = line + '\n';
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if (n == -1 && errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CoordinatorLink::read_line(std::string &line, int timeout_ms, bool &closed) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        size_t end = input.find('\n');
+        if (end != std::string::npos) {
+            line.assign(input, 0, end);
+            input.erase(0, end + 1);
+            return true;
+        }
+
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+        if (left.count() <= 0) return false;
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, static_cast<int>(left.count()));
+        if (ready < 0 && errno != EINTR) {
+            closed = true;
+            return false;
+        }
+        if (ready <= 0) continue;
+
+        char buffer[65536];
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            input.append(buffer, n);
+        } else if (n == 0 || errno != EINTR) {
+            closed = true;
+            return false;
+        }
+    }
+}
+
+void CoordinatorLink::finish() {
+    {
+        std::lock_guard<std::mutex> lock(task_mutex);
+        finished = true;
+    }
+    task_ready.notify_all();
+}
+
+#else
+
+bool distributed_supported() {
+    return false;
+}
+
+void run_coordinator(const CoordinatorConfig &) {}
+
+CoordinatorLink::~CoordinatorLink() = default;
+
+bool CoordinatorLink::connect(const std::string &, int, std::string &error) {
+    error = "Worker nodes are not supported on this platform";
+    return false;
+}
+
+bool CoordinatorLink::run() {
+    return false;
+}
+
+bool CoordinatorLink::next_task(int, GameTask &) {
+    return false;
+}
+
+void CoordinatorLink::report_result(int, Color) {}
+
+void CoordinatorLink::report_record(const GameRecord &) {}
+
+bool CoordinatorLink::send_line(const std::string &) {
+    return false;
+}
+
+bool CoordinatorLink::read_line(std::string &, int, bool &closed) {
+    closed = true;
+    return false;
+}
+
+void CoordinatorLink::finish() {}
+
+#endif
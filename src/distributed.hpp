@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game_record.hpp"
+#include "tournament.hpp"
+#include "types.hpp"
+
+// --- Distributed Matches ---
+// A match can be spread over several machines. The coordinator is the arena
+// the GUI talks to, with Listen set: it generates the games, scores them and
+// archives their notation, but plays none itself. Worker nodes are arena
+// processes started with `--worker <address>`; each plays games on its own
+// pool of workers and sends back the results, and connects again for the
+// next match.
+//
+// Addresses are "unix:<path>" or "tcp:<host>:<port>". Both sides exchange
+// newline-terminated, tab-separated text messages:
+//
+//   worker -> coordinator   hello <version> <slots>
+//                           record <hex of the encoded GameRecord>
+//                           result <game id> <R|B|N>
+//                           ping
+//   coordinator -> worker   option <name> <value>
+//                           start <slots> <ping ms> <seed>
+//                           task <slot> <GameTask fields>
+//                           ping | done | stop
+//
+// Each game handed to a worker node is leased to it for as long as its
+// connection lives. A node that closes its connection or stays silent for
+// LeaseMs is dropped, and its unfinished games are handed to other nodes.
+
+constexpr int DISTRIBUTED_PROTOCOL_VERSION = 1;
+
+// Whether distributed matches are available on this platform (Linux only).
+bool distributed_supported();
+
+struct CoordinatorConfig {
+    std::string address;
+    int slots = 1;  // Game slots over all worker nodes
+    int lease_ms = 10000;
+    std::uint64_t seed = 0;
+    std::vector<std::pair<std::string, std::string>> options;  // Sent to every node
+};
+
+// Serves the games of the current match to worker nodes until all are
+// played or the match is stopped. Games are taken with next_game_task and
+// take_unplayed_game and scored with record_game_result on this thread.
+void run_coordinator(const CoordinatorConfig &config);
+
+// The worker node's end of a connection to a coordinator. The network thread
+// calls connect() and then run(); the game threads take tasks and report
+// results concurrently.
+class CoordinatorLink {
+   public:
+    CoordinatorLink() = default;
+    ~CoordinatorLink();
+
+    CoordinatorLink(const CoordinatorLink &) = delete;
+    CoordinatorLink &operator=(const CoordinatorLink &) = delete;
+
+    // Connects and offers `slots` game slots. On success the options, the
+    // slots granted and the match seed are known.
+    bool connect(const std::string &address, int slots, std::string &error);
+
+    const std::vector<std::pair<std::string, std::string>> &options() const { return options_; }
+    int slots() const { return slots_; }
+    std::uint64_t seed() const { return seed_; }
+
+    // Receives tasks and sends pings until the coordinator ends the match or
+    // the connection is lost. Returns true if the match ended normally.
+    bool run();
+
+    // Waits for the next game of `slot`. Returns false when there are none.
+    bool next_task(int slot, GameTask &task);
+    void report_result(int game_id, Color result);
+    void report_record(const GameRecord &record);
+
+   private:
+    int fd = -1;
+    std::string input;  // Received bytes not yet split into lines
+    std::vector<std::pair<std::string, std::string>> options_;
+    int slots_ = 0;
+    int ping_ms = 1000;
+    std::uint64_t seed_ = 0;
+
+    std::mutex send_mutex;
+    std::mutex task_mutex;
+    std::condition_variable task_ready;
+    std::vector<std::deque<GameTask>> tasks;  // Per slot
+    bool finished = false;                    // No further tasks will come
+
+    bool send_line(const std::string &line);
+    // Reads the next line, waiting at most `timeout_ms`. Returns false on
+    // timeout or when the connection is closed.
+    bool read_line(std::string &line, int timeout_ms, bool &closed);
+    void finish();
+};
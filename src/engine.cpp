@@ -4,23 +4,31 @@
 #include <chrono>
 #include <format>
 #include <iostream>
-#include <sstream>
 #include <thread>
 
 #include "protocol.hpp"
 
-Engine::Engine(std::string name, int job_id) : name(std::move(name)), logger(name, job_id) {}
+Engine::Engine(std::string name, int job_id) : name(std::move(name)), logger(this->name, job_id) {}
 
-bool Engine::start(const std::string &path) {
+bool Engine::start(const std::string &path, const CpuSet &cpus) {
     // GUI will get this info from JAI Engine, not the child process directly.
     // std::cout << std::format("Starting engine '{}' with command: {}\n", name,
     // path);
-    return process.start(path);
+    return process.start(path, cpus);
 }
 
 void Engine::stop() {
+    if (!process.is_running()) return;
+    request_quit();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ENGINE_QUIT_GRACE_MS));
+    kill();
+}
+
+void Engine::request_quit() {
     process.write_line("quit");
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+void Engine::kill() {
     process.stop();
 }
 
@@ -89,77 +97,199 @@ const std::string &Engine::get_name() const {
     return name;
 }
 
-void Engine::set_position(std::string_view fen, const std::vector<std::string> &moves) {
-    std::string cmd = std::format("position fen {}", fen);
-    if (!moves.empty()) {
-        cmd += " moves";
-        for (const auto &move : moves) {
-            cmd += " " + move;
+void Engine::set_identity(const std::string &new_name, int job_id) {
+    name = new_name;
+    logger.open(name, job_id);
+}
+
+void Engine::request_new_game() {
+    position_fen.clear();
+    position_cmd.clear();
+    position_moves = 0;
+
+    for (const char *cmd : {"ucinewgame", "isready"}) {
+        logger.log_to_engine(cmd);
+        process.write_line(cmd);
+    }
+}
+
+bool Engine::new_game() {
+    request_new_game();
+
+    std::string line;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(ENGINE_READY_TIMEOUT_MS);
+    while (true) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        auto status = process.read_line(line, std::max<int>(0, left.count()));
+        if (status == EngineProcess::ReadStatus::TIMEOUT) {
+            send_info_string(std::format("Error: Engine {} did not answer isready.", name));
+            process.stop();
+            return false;
         }
+        if (status == EngineProcess::ReadStatus::CLOSED) return false;
+        logger.log_from_engine(line);
+        if (line == "readyok") return true;
+    }
+}
+
+Engine::PollResult Engine::poll_ready() {
+    std::string line;
+    while (true) {
+        auto status = process.read_line(line, 0);
+        if (status == EngineProcess::ReadStatus::TIMEOUT) return PollResult::PENDING;
+        if (status == EngineProcess::ReadStatus::CLOSED) return PollResult::DIED;
+        logger.log_from_engine(line);
+        if (line == "readyok") return PollResult::DONE;
+    }
+}
+
+void Engine::flush_log() {
+    logger.flush();
+}
+
+bool Engine::is_alive() {
+    return process.check_alive();
+}
+
+void Engine::set_position(std::string_view fen, std::span<const std::string> moves) {
+    // Start over for a new game or position; otherwise only append new moves.
+    if (fen != position_fen || moves.size() < position_moves) {
+        position_fen = fen;
+        position_cmd = std::format("position fen {}", fen);
+        position_moves = 0;
+    }
+    for (; position_moves < moves.size(); ++position_moves) {
+        if (position_moves == 0) position_cmd += " moves";
+        position_cmd += ' ';
+        position_cmd += moves[position_moves];
     }
-    logger.log_to_engine(cmd);
-    process.write_line(cmd);
+    logger.log_to_engine(position_cmd);
+    process.write_line(position_cmd);
 }
 
-std::string Engine::go(const std::string &go_command, bool is_primary_game) {
+void Engine::start_search(const std::string &go_command) {
     // Reset last eval state for this search
     last_eval_has_score = false;
     last_eval_cp = 0;
+    last_search_timed_out = false;
+    last_info = SearchInfo();
+    last_pv.clear();
 
     logger.log_to_engine(go_command);
+    process.mark_output();
     process.write_line(go_command);
+    go_sent_time = std::chrono::steady_clock::now();
+    bestmove_time.reset();
+}
+
+std::string Engine::wait_for_bestmove(bool is_primary_game, int timeout_ms) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+    std::string line, best_move;
     while (true) {
-        std::string line = process.read_line();
-        logger.log_from_engine(line);
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            wait_ms = std::max<int>(0, left.count());
+        }
 
-        if (line.empty()) {  // Check for empty line / process crash first
-            if (!process.is_running()) {
-                send_info_string(std::format("Error: Engine {} has stopped responding.", name));
-                return "resign";
-            }
-            continue;  // Could be an empty line for other reasons, just wait for more
-                       // output
+        auto status = process.read_line(line, wait_ms);
+        if (status == EngineProcess::ReadStatus::TIMEOUT) {
+            // The engine overran its clock, or hangs: it loses on time. Kill it
+            // so that the worker can move on; the pool restarts it next game.
+            abort_search();
+            return "";
+        }
+        if (status == EngineProcess::ReadStatus::CLOSED) {
+            send_info_string(std::format("Error: Engine {} has stopped responding.", name));
+            return "resign";
+        }
+        if (handle_search_line(line, is_primary_game, best_move)) {
+            return best_move;
         }
+    }
+}
 
-        // Forward UCI info lines to the GUI and parse eval
-        if (line.rfind("info", 0) == 0) {
-            // Don't forward info string lines (engine's own messages)
-            if (line.rfind("info string", 0) != 0) {
-                // Parse score: "info ... score cp N" or "info ... score mate M"
-                std::stringstream iss(line);
-                std::string tok;
-                while (iss >> tok) {
-                    if (tok == "score") {
-                        std::string type; iss >> type; // cp or mate
-                        if (type == "cp") {
-                            int cp; if (iss >> cp) { last_eval_cp = cp; last_eval_has_score = true; }
-                        } else if (type == "mate") {
-                            int mate_in; if (iss >> mate_in) {
-                                // Encode mate score as ±(30000 - ply)
-                                int ply = mate_in < 0 ? -mate_in : mate_in;
-                                int magnitude = 30000 - ply;
-                                if (magnitude < 0) magnitude = 0;  // clamp just in case
-                                last_eval_cp = (mate_in >= 0) ? magnitude : -magnitude;
-                                last_eval_has_score = true;
-                            }
-                        }
-                    }
-                }
-                // Conditional send for engine analysis
-                if (is_primary_game) {
-                    send_to_gui(line);  // Pass-through the info line
+Engine::PollResult Engine::poll_search(bool is_primary_game, std::string &best_move) {
+    std::string line;
+    while (true) {
+        auto status = process.read_line(line, 0);
+        if (status == EngineProcess::ReadStatus::TIMEOUT) return PollResult::PENDING;
+        if (status == EngineProcess::ReadStatus::CLOSED) {
+            send_info_string(std::format("Error: Engine {} has stopped responding.", name));
+            best_move = "resign";
+            return PollResult::DONE;
+        }
+        if (handle_search_line(line, is_primary_game, best_move)) {
+            return PollResult::DONE;
+        }
+    }
+}
+
+void Engine::abort_search() {
+    last_search_timed_out = true;
+    kill();
+}
+
+bool Engine::discard_output() {
+    std::string line;
+    while (true) {
+        auto status = process.read_line(line, 0);
+        if (status == EngineProcess::ReadStatus::TIMEOUT) return true;
+        if (status == EngineProcess::ReadStatus::CLOSED) return false;
+        logger.log_from_engine(line);
+    }
+}
+
+#ifndef _WIN32
+int Engine::output_fd() const {
+    return process.output_fd();
+}
+#endif
+
+bool Engine::handle_search_line(const std::string &line, bool is_primary_game,
+                                std::string &best_move) {
+    logger.log_from_engine(line);
+
+    if (line.empty()) {
+        return false;  // Blank line, just wait for more output
+    }
+
+    // Forward UCI info lines to the GUI and parse eval
+    if (line.starts_with("info")) {
+        // Don't forward info string lines (engine's own messages)
+        if (!line.starts_with("info string")) {
+            SearchInfo info;
+            // Only the main line counts towards the engine's evaluation.
+            if (parse_info_line(line, info) && info.multipv <= 1) {
+                if (info.score_type != SearchInfo::ScoreType::NONE) {
+                    last_eval_cp = info.score_cp();
+                    last_eval_has_score = true;
                 }
+                last_info.update(info);
+                if (!info.pv.empty()) last_pv.assign(info.pv);
+            }
+            // Conditional send for engine analysis
+            if (is_primary_game) {
+                send_search_info(line, info.depth, info.multipv);
             }
-            continue;  // Continue listening
         }
+        return false;  // Continue listening
+    }
 
-        if (line.rfind("bestmove", 0) == 0) {
-            std::stringstream ss(line);
-            std::string token, best_move;
-            ss >> token >> best_move;
-            return best_move;
-        }
+    if (line.starts_with("bestmove")) {
+        bestmove_time = std::chrono::steady_clock::now();
+        std::string_view rest = std::string_view(line).substr(8);
+        size_t start = rest.find_first_not_of(' ');
+        best_move = start == std::string_view::npos
+                        ? std::string()
+                        : std::string(rest.substr(start, rest.find(' ', start) - start));
+        return true;
     }
+    return false;
 }
 
 int Engine::get_last_eval_cp() const {
@@ -168,4 +298,20 @@ int Engine::get_last_eval_cp() const {
 
 bool Engine::has_last_eval() const {
     return last_eval_has_score;
+}
+
+const SearchInfo &Engine::get_last_info() const {
+    return last_info;
+}
+
+const std::string &Engine::get_last_pv() const {
+    return last_pv;
+}
+
+SearchTiming Engine::get_search_timing() const {
+    return {go_sent_time, process.first_output_time(), bestmove_time};
+}
+
+bool Engine::timed_out() const {
+    return last_search_timed_out;
 }
\ No newline at end of file
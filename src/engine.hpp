@@ -1,31 +1,123 @@
 #pragma once
 
+#include <chrono>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
-#include <vector>
 
 #include "engine_process.hpp"
 #include "logger.hpp"
+#include "uci_info.hpp"
 
 // --- Engine Abstraction ---
 
+// How long an engine may take to answer "isready" before it is considered hung.
+constexpr int ENGINE_READY_TIMEOUT_MS = 30000;
+// How long an engine is given to exit after "quit" before it is killed.
+constexpr int ENGINE_QUIT_GRACE_MS = 100;
+
+// When the milestones of the last search happened.
+struct SearchTiming {
+    std::chrono::steady_clock::time_point go_sent;
+    std::optional<std::chrono::steady_clock::time_point> first_output;  // First byte after go
+    std::optional<std::chrono::steady_clock::time_point> bestmove;      // bestmove line read
+};
+
 class Engine {
+   public:
+    // Outcome of polling an engine without blocking.
+    enum class PollResult {
+        PENDING,  // The awaited reply has not arrived yet
+        DONE,     // The reply arrived
+        DIED      // The engine exited before replying
+    };
+
    private:
     EngineProcess process;
     std::string name;
     Logger logger;
     int last_eval_cp = 0;          // Last reported evaluation in centipawns
     bool last_eval_has_score = false;  // Whether a score was parsed in the last search
+    bool last_search_timed_out = false;  // Whether the last search hit its deadline
+    SearchInfo last_info;  // Latest values reported during the last search
+    std::string last_pv;   // Latest principal variation of the last search
+    std::chrono::steady_clock::time_point go_sent_time;
+    std::optional<std::chrono::steady_clock::time_point> bestmove_time;
+
+    // "position fen ... moves ..." command of the current game. Moves are only
+    // ever appended during a game, so each ply extends this buffer instead of
+    // rebuilding it.
+    std::string position_cmd;
+    std::string position_fen;
+    size_t position_moves = 0;  // Number of moves already in position_cmd
+
+    // Handles one line of output during a search. Returns true once the line
+    // is the bestmove, which is then stored in `best_move`.
+    bool handle_search_line(const std::string &line, bool is_primary_game, std::string &best_move);
 
    public:
     Engine(std::string name, int job_id = 0);
 
-    bool start(const std::string &path);
+    // Starts the engine process, pinned to `cpus` if not empty.
+    bool start(const std::string &path, const CpuSet &cpus = {});
+    // Sends "quit", gives the engine a moment to exit and kills it.
     void stop();
+    // Sends "quit" without waiting for the engine to exit.
+    void request_quit();
+    // Kills the engine process immediately.
+    void kill();
     const std::string &get_name() const;
-    void set_position(std::string_view fen, const std::vector<std::string> &moves);
 
-    std::string go(const std::string &go_command, bool is_primary_game);
+    // Rename the engine and redirect its log for a new game. Used when a
+    // running engine process is reused instead of restarted.
+    void set_identity(const std::string &new_name, int job_id);
+
+    // Prepare a running engine for a new game: sends "ucinewgame" and waits
+    // for "readyok". Returns false if the engine died in the meantime.
+    bool new_game();
+
+    // Non-blocking variant of new_game(): request_new_game() sends the
+    // commands, poll_ready() consumes the output already available and
+    // reports DONE once "readyok" has arrived.
+    void request_new_game();
+    PollResult poll_ready();
+
+    // Writes out the buffered debug log of this engine, e.g. at game end.
+    void flush_log();
+
+    // Returns true if the engine process is still alive.
+    bool is_alive();
+
+    void set_position(std::string_view fen, std::span<const std::string> moves);
+
+    // Sends the go command. The answer is collected with wait_for_bestmove()
+    // or poll_search().
+    void start_search(const std::string &go_command);
+
+    // Waits for the bestmove of the running search. If it does not arrive
+    // within `timeout_ms` (no limit if negative), the search is aborted and an
+    // empty move is returned. Returns "resign" if the engine died.
+    std::string wait_for_bestmove(bool is_primary_game, int timeout_ms = -1);
+
+    // Non-blocking variant of wait_for_bestmove(): consumes the output already
+    // available and returns DONE once `best_move` is set ("resign" if the
+    // engine died), PENDING otherwise.
+    PollResult poll_search(bool is_primary_game, std::string &best_move);
+
+    // Kills the engine because its search overran the deadline; timed_out()
+    // becomes true.
+    void abort_search();
+
+    // Reads and logs any output of an idle engine, so that it does not keep
+    // its pipe readable. Returns false if the engine has exited.
+    bool discard_output();
+
+#ifndef _WIN32
+    // Pipe the engine writes its output to, for waiting on many engines at
+    // once. -1 if the engine is not running.
+    int output_fd() const;
+#endif
 
     // Apply UCI options to the engine process
     void apply_uci_options(const std::string &options_str);
@@ -33,4 +125,14 @@ class Engine {
     // Accessors for last evaluation
     int get_last_eval_cp() const;
     bool has_last_eval() const;
+
+    // Latest depth, nodes, score etc. reported during the last search (no pv).
+    const SearchInfo &get_last_info() const;
+    const std::string &get_last_pv() const;
+
+    // Timing of the last search, for latency accounting.
+    SearchTiming get_search_timing() const;
+
+    // Whether the last search was aborted because it exceeded its deadline.
+    bool timed_out() const;
 };
\ No newline at end of file
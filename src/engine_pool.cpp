@@ -0,0 +1,135 @@
+#include "engine_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+extern std::vector<Engine *> g_active_engines;
+extern std::mutex g_engines_mutex;
+
+EnginePool::~EnginePool() {
+    shutdown();
+}
+
+bool EnginePool::launch(Slot &slot) {
+    if (!slot.engine->start(slot.path, slot.cpus)) {
+        return false;
+    }
+    slot.engine->apply_uci_options(slot.options);
+    return true;
+}
+
+Engine *EnginePool::acquire(const std::string &path, const std::string &options,
+                            const CpuSet &cpus, const std::string &name, int job_id,
+                            bool wait_ready) {
+    // Prefer a process already configured with these options. Options cannot
+    // be taken back from a running engine, so one configured differently is
+    // only reused by restarting it.
+    auto it = std::find_if(slots.begin(), slots.end(), [&](const Slot &s) {
+        return !s.in_use && s.path == path && s.options == options && s.cpus == cpus;
+    });
+    if (it == slots.end()) {
+        it = std::find_if(slots.begin(), slots.end(), [&](const Slot &s) {
+            return !s.in_use && s.path == path && s.cpus == cpus;
+        });
+    }
+
+    if (it == slots.end()) {
+        // First use of this engine on this worker: create a new process.
+        evict_idle();
+        Slot slot;
+        slot.path = path;
+        slot.options = options;
+        slot.cpus = cpus;
+        slot.engine = std::make_unique<Engine>(name, job_id);
+        if (!launch(slot)) {
+            return nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(g_engines_mutex);
+            g_active_engines.push_back(slot.engine.get());
+        }
+        slots.push_back(std::move(slot));
+        it = std::prev(slots.end());
+    } else {
+        it->engine->set_identity(name, job_id);
+        if (!it->engine->is_alive() || it->options != options) {
+            // The engine crashed since its last game, or was configured for
+            // another player: restart it from scratch.
+            it->engine->stop();
+            it->options = options;
+            if (!launch(*it)) {
+                return nullptr;
+            }
+        }
+    }
+
+    if (!wait_ready) {
+        it->engine->request_new_game();
+    } else if (!it->engine->new_game()) {
+        return nullptr;
+    }
+    it->in_use = true;
+    it->last_used = ++use_count;
+    return it->engine.get();
+}
+
+void EnginePool::evict_idle() {
+    auto oldest = slots.end();
+    size_t idle = 0;
+    for (auto it = slots.begin(); it != slots.end(); ++it) {
+        if (it->in_use) continue;
+        idle++;
+        if (oldest == slots.end() || it->last_used < oldest->last_used) oldest = it;
+    }
+    if (idle < MAX_IDLE_ENGINES) return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_engines_mutex);
+        g_active_engines.erase(
+            std::remove(g_active_engines.begin(), g_active_engines.end(), oldest->engine.get()),
+            g_active_engines.end());
+    }
+    oldest->engine->stop();
+    slots.erase(oldest);
+}
+
+void EnginePool::release(Engine *engine) {
+    for (auto &slot : slots) {
+        if (slot.engine.get() == engine && slot.in_use) {
+            slot.engine->flush_log();
+            slot.in_use = false;
+        }
+    }
+}
+
+void EnginePool::release_all() {
+    for (auto &slot : slots) {
+        if (slot.in_use) slot.engine->flush_log();
+        slot.in_use = false;
+    }
+}
+
+void EnginePool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(g_engines_mutex);
+        for (auto &slot : slots) {
+            g_active_engines.erase(
+                std::remove(g_active_engines.begin(), g_active_engines.end(), slot.engine.get()),
+                g_active_engines.end());
+        }
+    }
+    // Ask every engine to quit first, so that a large pool waits for the
+    // grace period once instead of once per engine.
+    for (auto &slot : slots) {
+        slot.engine->request_quit();
+    }
+    if (!slots.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ENGINE_QUIT_GRACE_MS));
+    }
+    for (auto &slot : slots) {
+        slot.engine->kill();
+    }
+    slots.clear();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+// --- Engine Pool ---
+// Keeps engine processes alive across the games played by one worker, so that
+// process startup and engine initialization (NNUE loading, hash allocation)
+// are paid once per worker instead of once per game.
+//
+// Engines are matched by path, options and core set. Between games a reused
+// engine receives "ucinewgame" and is synchronized with "isready". A process
+// is restarted if it has crashed, or if the only free one with this path was
+// started with other options, since options already sent cannot be undone.
+//
+// In tournaments of more than two engines a worker meets many engines over
+// time; at most MAX_IDLE_ENGINES idle processes are kept, and the one used
+// longest ago is stopped to make room for a new one.
+class EnginePool {
+   public:
+    static constexpr size_t MAX_IDLE_ENGINES = 2;
+
+   private:
+    struct Slot {
+        std::string path;
+        std::string options;  // Options currently applied to the process
+        CpuSet cpus;          // Cores the process is pinned to
+        std::unique_ptr<Engine> engine;
+        bool in_use = false;          // Acquired for the current game
+        std::uint64_t last_used = 0;  // Value of use_count when last acquired
+    };
+
+    std::vector<Slot> slots;
+    std::uint64_t use_count = 0;
+
+    // Stops the least recently used idle engine if MAX_IDLE_ENGINES are idle.
+    void evict_idle();
+
+    // Starts (or restarts) the process of a slot and applies its options.
+    bool launch(Slot &slot);
+
+   public:
+    EnginePool() = default;
+    ~EnginePool();
+
+    EnginePool(const EnginePool &) = delete;
+    EnginePool &operator=(const EnginePool &) = delete;
+
+    // Returns an engine ready for a new game, named `name` and logging under
+    // `job_id`. Two acquires with the same path during one game (self-play)
+    // yield two distinct processes. Returns nullptr if the engine cannot be
+    // started. The process is pinned to `cpus` (no pinning if empty). With
+    // `wait_ready` false, "isready" is only sent and the caller waits for the
+    // answer with Engine::poll_ready().
+    Engine *acquire(const std::string &path, const std::string &options, const CpuSet &cpus,
+                    const std::string &name, int job_id, bool wait_ready = true);
+
+    // Marks one engine as free for the next game. Its process keeps running.
+    void release(Engine *engine);
+
+    // Marks all engines as free for the next game. Processes keep running.
+    void release_all();
+
+    // Stops all engine processes.
+    void shutdown();
+};
@@ -1,15 +1,47 @@
 #include "engine_process.hpp"
 
+#include <chrono>
 #include <iostream>
 #include <vector>
 
+#ifndef _WIN32
+#include <fcntl.h>
+
+#include <cerrno>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+// Creates a pipe whose ends are close-on-exec, so that they do not leak into
+// engines started concurrently by other workers; an inherited write end would
+// keep this engine's EOF from ever being seen. dup2() onto stdin or stdout
+// clears the flag in the engine's own process.
+bool open_pipe(int fds[2]) {
+#ifdef __linux__
+    return pipe2(fds, O_CLOEXEC) == 0;
+#else
+    // Without pipe2() a fork() on another thread can still slip in here.
+    if (pipe(fds) == -1) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+}  // namespace
+#endif
+
 EngineProcess::EngineProcess() = default;
 
 EngineProcess::~EngineProcess() {
     stop();
 }
 
-bool EngineProcess::start(const std::string &command) {
+bool EngineProcess::start(const std::string &command, [[maybe_unused]] const CpuSet &cpus) {
 #ifdef _WIN32
     SECURITY_ATTRIBUTES sa;
     sa.nLength = sizeof(SECURITY_ATTRIBUTES);
@@ -42,18 +74,43 @@ bool EngineProcess::start(const std::string &command) {
     int parent_to_child[2];
     int child_to_parent[2];
 
-    if (pipe(parent_to_child) == -1 || pipe(child_to_parent) == -1) {
+    if (!open_pipe(parent_to_child)) {
+        std::cerr << "Pipe creation failed.\n";
+        return false;
+    }
+    if (!open_pipe(child_to_parent)) {
         std::cerr << "Pipe creation failed.\n";
+        close(parent_to_child[0]);
+        close(parent_to_child[1]);
         return false;
     }
 
+#ifdef __linux__
+    // Built before fork(): the child should only make system calls.
+    cpu_set_t cpu_mask;
+    CPU_ZERO(&cpu_mask);
+    for (int cpu : cpus) CPU_SET(cpu, &cpu_mask);
+#endif
+
     pid_ = fork();
     if (pid_ == -1) {
         std::cerr << "Fork failed.\n";
+        for (int fd : {parent_to_child[0], parent_to_child[1], child_to_parent[0],
+                       child_to_parent[1]}) {
+            close(fd);
+        }
         return false;
     }
 
     if (pid_ == 0) {  // Child process
+        // Run in a process group of its own, so that stop() also kills
+        // anything the shell spawned (the shell does not always exec).
+        setpgid(0, 0);
+#ifdef __linux__
+        // Inherited across exec by the engine and every thread it creates.
+        if (!cpus.empty()) sched_setaffinity(0, sizeof(cpu_mask), &cpu_mask);
+#endif
+
         close(parent_to_child[1]);
         dup2(parent_to_child[0], STDIN_FILENO);
         close(parent_to_child[0]);
@@ -63,17 +120,15 @@ bool EngineProcess::start(const std::string &command) {
         close(child_to_parent[1]);
 
         execl("/bin/sh", "sh", "-c", command.c_str(), (char *)NULL);
-        exit(127);
+        _exit(127);
     } else {  // Parent process
+        setpgid(pid_, pid_);
         close(parent_to_child[0]);
-        engine_pipe_write_ = fdopen(parent_to_child[1], "w");
+        write_fd_ = parent_to_child[1];
 
         close(child_to_parent[1]);
-        engine_pipe_read_ = fdopen(child_to_parent[0], "r");
-
-        if (!engine_pipe_write_ || !engine_pipe_read_) return false;
-
-        setvbuf(engine_pipe_write_, NULL, _IOLBF, 0);
+        read_fd_ = child_to_parent[0];
+        fcntl(read_fd_, F_SETFL, fcntl(read_fd_, F_GETFL) | O_NONBLOCK);
     }
     return true;
 #endif
@@ -97,19 +152,20 @@ void EngineProcess::stop() {
     }
 #else
     if (pid_ > 0) {
-        kill(pid_, SIGKILL);
+        kill(-pid_, SIGKILL);
         waitpid(pid_, NULL, 0);
         pid_ = -1;
     }
-    if (engine_pipe_read_) {
-        fclose(engine_pipe_read_);
-        engine_pipe_read_ = nullptr;
+    if (read_fd_ != -1) {
+        close(read_fd_);
+        read_fd_ = -1;
     }
-    if (engine_pipe_write_) {
-        fclose(engine_pipe_write_);
-        engine_pipe_write_ = nullptr;
+    if (write_fd_ != -1) {
+        close(write_fd_);
+        write_fd_ = -1;
     }
 #endif
+    read_buffer.clear();
 }
 
 void EngineProcess::write_line(const std::string &line) {
@@ -119,51 +175,88 @@ void EngineProcess::write_line(const std::string &line) {
     std::string full_line = line + "\n";
     WriteFile(h_child_stdin_write_, full_line.c_str(), full_line.length(), &bytes_written, NULL);
 #else
-    fprintf(engine_pipe_write_, "%s\n", line.c_str());
-    fflush(engine_pipe_write_);
+    std::string full_line = line + "\n";
+    size_t written = 0;
+    while (written < full_line.size()) {
+        ssize_t n = write(write_fd_, full_line.data() + written, full_line.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;  // Broken pipe: the read side will notice the engine has exited
+        }
+        written += static_cast<size_t>(n);
+    }
 #endif
 }
 
-std::string EngineProcess::read_line() {
-    if (!is_running()) return "";
-#ifdef _WIN32
+bool EngineProcess::take_line(std::string &line) {
+    size_t newline_pos = read_buffer.find('\n');
+    if (newline_pos == std::string::npos) return false;
+    line.assign(read_buffer, 0, newline_pos);
+    read_buffer.erase(0, newline_pos + 1);
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return true;
+}
+
+EngineProcess::ReadStatus EngineProcess::read_line(std::string &line, int timeout_ms) {
+    using clock = std::chrono::steady_clock;
+    auto deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    // Milliseconds left before the deadline; -1 means wait forever.
+    auto remaining_ms = [&]() -> int {
+        if (timeout_ms < 0) return -1;
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - clock::now());
+        return left.count() > 0 ? static_cast<int>(left.count()) : 0;
+    };
+
     while (true) {
-        size_t newline_pos = windows_read_buffer.find('\n');
-        if (newline_pos != std::string::npos) {
-            std::string line = windows_read_buffer.substr(0, newline_pos);
-            windows_read_buffer.erase(0, newline_pos + 1);
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            return line;
-        }
+        if (take_line(line)) return ReadStatus::LINE;
+        if (!is_running()) return ReadStatus::CLOSED;
 
+        int wait_ms = remaining_ms();
         char buffer[4096];
-        DWORD bytes_read;
-        if (ReadFile(h_child_stdout_read_, buffer, sizeof(buffer), &bytes_read, NULL) &&
+#ifdef _WIN32
+        DWORD available = 0;
+        bool pipe_open = PeekNamedPipe(h_child_stdout_read_, NULL, 0, NULL, &available, NULL);
+        if (pipe_open && available == 0) {
+            if (wait_ms == 0) return ReadStatus::TIMEOUT;
+            Sleep(1);  // Anonymous pipes cannot be waited on; poll them
+            continue;
+        }
+        DWORD bytes_read = 0;
+        if (pipe_open &&
+            ReadFile(h_child_stdout_read_, buffer, sizeof(buffer), &bytes_read, NULL) &&
             bytes_read > 0) {
-            windows_read_buffer.append(buffer, bytes_read);
-        } else {
-            // Pipe closed or error
-            if (!windows_read_buffer.empty()) {
-                std::string line = windows_read_buffer;
-                windows_read_buffer.clear();
-                return line;
-            }
-            return "";
+            if (!first_output) first_output = clock::now();
+            read_buffer.append(buffer, bytes_read);
+            continue;
         }
-    }
 #else
-    char buffer[4096];
-    if (fgets(buffer, sizeof(buffer), engine_pipe_read_)) {
-        std::string line = buffer;
-        while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
-            line.pop_back();
+        pollfd pfd{read_fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, wait_ms);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) return ReadStatus::TIMEOUT;
+
+        ssize_t bytes_read = ready > 0 ? read(read_fd_, buffer, sizeof(buffer)) : -1;
+        if (bytes_read > 0) {
+            if (!first_output) first_output = clock::now();
+            read_buffer.append(buffer, static_cast<size_t>(bytes_read));
+            continue;
         }
-        return line;
-    }
-    return "";
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EINTR)) continue;
 #endif
+        // Pipe closed or error: the engine has exited. Hand out any final
+        // unterminated line before reporting it.
+        if (!read_buffer.empty()) {
+            line = std::move(read_buffer);
+            read_buffer.clear();
+            stop();
+            return ReadStatus::LINE;
+        }
+        stop();
+        return ReadStatus::CLOSED;
+    }
 }
 
 bool EngineProcess::is_running() const {
@@ -172,4 +265,22 @@ bool EngineProcess::is_running() const {
 #else
     return pid_ != -1;
 #endif
+}
+
+bool EngineProcess::check_alive() {
+    if (!is_running()) return false;
+#ifdef _WIN32
+    if (WaitForSingleObject(pi_.hProcess, 0) == WAIT_OBJECT_0) {
+        stop();
+        return false;
+    }
+#else
+    if (waitpid(pid_, NULL, WNOHANG) == pid_) {
+        kill(-pid_, SIGKILL);  // Leftovers of the group, if any
+        pid_ = -1;             // Already reaped, nothing left to wait for
+        stop();
+        return false;
+    }
+#endif
+    return true;
 }
\ No newline at end of file
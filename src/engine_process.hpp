@@ -1,10 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <optional>
 #include <string>
 
+#include "cpu_affinity.hpp"
+
 #ifdef _WIN32
 #include <windows.h>
 #else
+#include <poll.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -14,6 +19,14 @@
 // --- Engine Process Management ---
 
 class EngineProcess {
+   public:
+    // Outcome of a read_line() call.
+    enum class ReadStatus {
+        LINE,     // A complete line was read
+        TIMEOUT,  // The deadline passed before a complete line arrived
+        CLOSED    // The engine has exited (or was never started)
+    };
+
    private:
 #ifdef _WIN32
     PROCESS_INFORMATION pi_{};
@@ -21,21 +34,48 @@ class EngineProcess {
     HANDLE h_child_stdin_write_ = NULL;
     HANDLE h_child_stdout_read_ = NULL;
     HANDLE h_child_stdout_write_ = NULL;
-    // Buffer for Windows to handle multiple lines in one read
-    std::string windows_read_buffer;
 #else
-    FILE *engine_pipe_read_ = nullptr;
-    FILE *engine_pipe_write_ = nullptr;
+    // Raw pipe ends. The read end is non-blocking and waited on with poll().
+    int read_fd_ = -1;
+    int write_fd_ = -1;
     pid_t pid_ = -1;
 #endif
+    // Output received from the engine that does not form a complete line yet
+    std::string read_buffer;
+    // When the first output arrived after the last mark_output()
+    std::optional<std::chrono::steady_clock::time_point> first_output;
+
+    // Moves the first complete line out of read_buffer, if there is one.
+    bool take_line(std::string &line);
 
    public:
     EngineProcess();
     ~EngineProcess();
 
-    bool start(const std::string &command);
+    // Starts the engine, pinned to `cpus` if not empty (Linux only).
+    bool start(const std::string &command, const CpuSet &cpus = {});
     void stop();
     void write_line(const std::string &line);
-    std::string read_line();
+
+    // Reads one line of engine output, waiting at most `timeout_ms`
+    // milliseconds (forever if negative). Never blocks past the deadline, so a
+    // hung engine cannot stall the caller.
+    ReadStatus read_line(std::string &line, int timeout_ms = -1);
     bool is_running() const;
+
+    // Starts watching for the next output; first_output_time() then reports
+    // when its first byte was read from the pipe.
+    void mark_output() { first_output.reset(); }
+    std::optional<std::chrono::steady_clock::time_point> first_output_time() const {
+        return first_output;
+    }
+
+#ifndef _WIN32
+    // Read end of the engine's stdout, or -1 if the engine is not running.
+    int output_fd() const { return read_fd_; }
+#endif
+
+    // Reaps the child if it has exited on its own (e.g. crashed while idle).
+    // Returns true if the process is still alive.
+    bool check_alive();
 };
\ No newline at end of file
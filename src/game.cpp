@@ -11,9 +11,8 @@
 
 #include "protocol.hpp"
 #include "types.hpp"
+#include "zobrist.hpp"
 
-extern const std::map<char, Piece> char_to_piece;
-extern const std::map<Piece, char> piece_to_char;
 extern std::atomic<bool> g_stop_match;
 
 Game::Game(Engine &r_eng, Engine &b_eng, std::string_view fen, std::optional<TimeControl> tc,
@@ -25,31 +24,24 @@ Game::Game(Engine &r_eng, Engine &b_eng, std::string_view fen, std::optional<Tim
     parse_fen(fen);
 }
 
+Game::Game(Engine &r_eng, Engine &b_eng, const BookRecord &start, std::optional<TimeControl> tc,
+           int timeout_buffer_ms)
+    : red_engine(r_eng), black_engine(b_eng), initial_fen(book_record_fen(start)) {
+    if (tc) {
+        time_manager.emplace(*tc, timeout_buffer_ms);
+    }
+    load_book_record(start);
+}
+
 // ... (parse_fen, get_piece_at_coord, set_piece_at_coord remain the same) ...
 void Game::parse_fen(std::string_view fen) {
-    board.assign(10, std::vector<Piece>(9, Piece::EMPTY));
-
     auto parts = fen | std::views::split(' ') | std::ranges::to<std::vector<std::string>>();
     if (parts.size() < 3) {
         throw std::runtime_error("Invalid FEN string: not enough parts.");
     }
 
     // Part 1: Board position
-    std::string_view board_part = parts[0];
-    int row = 0, col = 0;
-    for (char c : board_part) {
-        if (c == '/') {
-            row++;
-            col = 0;
-        } else if (isdigit(c)) {
-            col += c - '0';
-        } else {
-            if (col < 9 && row < 10) {
-                board[row][col] = (c == 'x' || c == 'X') ? Piece::HIDDEN : char_to_piece.at(c);
-                col++;
-            }
-        }
-    }
+    board.set_fen_board(parts[0]);
 
     // Part 2: Side to move
     std::string_view turn_part = parts[1];
@@ -59,175 +51,250 @@ void Game::parse_fen(std::string_view fen) {
     std::string_view pool_part = parts[2];
     piece_pool.from_string(pool_part);
 
+    reset_position_history();
+}
+
+void Game::load_book_record(const BookRecord &record) {
+    board.clear();
+    for (int sq = 0; sq < BOARD_SQUARES; ++sq) {
+        Piece p = record.piece_at(sq);
+        if (p != Piece::EMPTY) board.put_piece(sq, p);
+    }
+    current_turn = record.turn();
+    piece_pool.clear();
+    for (size_t slot = 0; slot < POOL_PIECES.size(); ++slot) {
+        piece_pool.set_count(POOL_PIECES[slot], record.pool[slot]);
+    }
+
+    reset_position_history();
+}
+
+void Game::reset_position_history() {
     // Record the initial position for repetition check
-    std::string fen_key =
-        generate_fen_board_part() + " " + (current_turn == Color::RED ? 'w' : 'b');
-    position_history[fen_key]++;
+    key_history.clear();
+    key_history.reserve(MAX_PLIES + 1);
+    irreversible_ply = 0;
+    record_position();
 }
 
 Piece Game::get_piece_at_coord(const std::string &coord) {
-    if (coord.length() != 2) return Piece::EMPTY;
-    int col = coord[0] - 'a';
-    int row = 9 - (coord[1] - '0');
-    if (row < 0 || row > 9 || col < 0 || col > 8) return Piece::EMPTY;
-    return board[row][col];
+    int sq = parse_square(coord);
+    return sq == NO_SQUARE ? Piece::EMPTY : board.piece_at(sq);
 }
 
 void Game::set_piece_at_coord(const std::string &coord, Piece p) {
-    if (coord.length() != 2) return;
-    int col = coord[0] - 'a';
-    int row = 9 - (coord[1] - '0');
-    if (row < 0 || row > 9 || col < 0 || col > 8) return;
-    board[row][col] = p;
+    int sq = parse_square(coord);
+    if (sq == NO_SQUARE) return;
+    board.put_piece(sq, p);
 }
 
 Color Game::run(bool is_primary_game) {
-    for (int move_count = 1;; ++move_count) {
-        if (move_count > 300) {
-            send_info_string("Game ends in a draw (move limit reached).");
-            if (is_primary_game) send_to_gui("info result 1/2-1/2");
-            return Color::NONE;
-        }
+    while (begin_turn(is_primary_game)) {
+        std::string best_move_str =
+            engine_to_move().wait_for_bestmove(is_primary_game, turn_deadline_ms);
+        if (!end_turn(best_move_str, is_primary_game)) break;
+    }
+    return game_result;
+}
 
-        if (g_stop_match) {
-            return Color::NONE;
-        }
+Engine &Game::engine_to_move() {
+    return (current_turn == Color::RED) ? red_engine : black_engine;
+}
 
-        Engine &current_engine = (current_turn == Color::RED) ? red_engine : black_engine;
-        Engine &opponent_engine = (current_turn == Color::RED) ? black_engine : red_engine;
+bool Game::end_game(Color result) {
+    game_result = result;
+    return false;
+}
 
-        auto moves_for_current_player = get_moves_for_color(current_turn);
-        current_engine.set_position(initial_fen, moves_for_current_player);
+bool Game::begin_turn(bool is_primary_game) {
+    if (++move_count > MAX_PLIES) {
+        send_info_string("Game ends in a draw (move limit reached).");
+        if (is_primary_game) send_to_gui("info result 1/2-1/2");
+        return end_game(Color::NONE);
+    }
 
-        std::string go_command = time_manager ? time_manager->get_go_command() : "go movetime 2000";
+    if (g_stop_match) {
+        return end_game(Color::NONE);
+    }
 
-        auto start_time = std::chrono::steady_clock::now();
-        std::string best_move_str = current_engine.go(go_command, is_primary_game);
-        auto end_time = std::chrono::steady_clock::now();
+    Engine &current_engine = engine_to_move();
+    std::string go_command = time_manager ? time_manager->get_go_command() : "go movetime 2000";
+    // The search is cut off as soon as the player has lost on time.
+    turn_deadline_ms = time_manager ? time_manager->get_deadline_ms(current_turn)
+                                    : 2000 + DEFAULT_TIMEOUT_BUFFER_MS;
+
+    auto write_start = std::chrono::steady_clock::now();
+    current_engine.set_position(initial_fen, get_moves_for_color(current_turn));
+    current_engine.start_search(go_command);
+    // The engine's clock runs from the moment the go command was sent.
+    turn_start = std::chrono::steady_clock::now();
+    turn_latency = MoveLatency{};
+    turn_latency.write_us = microseconds_between(write_start, turn_start);
+    return true;
+}
 
-        long long elapsed_ms =
-            std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+bool Game::end_turn(const std::string &best_move_str, bool is_primary_game) {
+    auto received = std::chrono::steady_clock::now();
+    SearchTiming timing = engine_to_move().get_search_timing();
 
-        // --- RESIGNATION / CRASH CHECK ---
-        if (best_move_str == "resign" || best_move_str.empty() || best_move_str == "(none)") {
-            std::string reason = "resigns or crashed";
-            if (best_move_str == "(none)") reason = "returned no move";
+    // Charge the engine up to when its bestmove was read, not up to when the
+    // scheduler got round to this game. A search cut off at the deadline is
+    // charged in full.
+    auto answered = timing.bestmove.value_or(received);
+    long long elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(answered - turn_start).count();
 
-            send_info_string(std::format("{} {}. {} wins.", current_engine.get_name(), reason,
-                                         opponent_engine.get_name()));
-            if (is_primary_game)
-                send_to_gui(
-                    std::format("info result {}", (current_turn == Color::RED ? "0-1" : "1-0")));
-            return (current_turn == Color::RED) ? Color::BLACK : Color::RED;
-        }
+    if (timing.first_output) {
+        turn_latency.first_output_us = microseconds_between(turn_start, *timing.first_output);
+    }
+    if (timing.bestmove) {
+        turn_latency.bestmove_us = microseconds_between(turn_start, *timing.bestmove);
+        turn_latency.dispatch_us = microseconds_between(*timing.bestmove, received);
+    }
 
-        // --- ILLEGAL MOVE VALIDATION ---
-        if (!validator.is_move_legal(best_move_str, current_turn, board)) {
-            validator.is_move_legal(best_move_str, current_turn, board);
-            send_info_string(std::format("{} made an illegal move ({}). {} wins.",
-                                         current_engine.get_name(), best_move_str,
-                                         opponent_engine.get_name()));
-            if (is_primary_game)
-                send_to_gui(
-                    std::format("info result {}", (current_turn == Color::RED ? "0-1" : "1-0")));
-            return (current_turn == Color::RED) ? Color::BLACK : Color::RED;
-        }
+    bool game_continues = apply_answer(best_move_str, elapsed_ms, is_primary_game);
 
-        // --- TIME CHECK ---
-        if (time_manager) {
-            time_manager->update(current_turn, elapsed_ms);
-            if (time_manager->is_out_of_time(current_turn)) {
-                send_info_string(std::format("{} loses on time. {} wins.",
-                                             current_engine.get_name(),
-                                             opponent_engine.get_name()));
-                if (is_primary_game)
-                    send_to_gui(std::format("info result {}",
-                                            (current_turn == Color::RED ? "0-1" : "1-0")));
-                return (current_turn == Color::RED) ? Color::BLACK : Color::RED;
-            }
-        }
+    turn_latency.arena_us = microseconds_between(received, std::chrono::steady_clock::now());
+    g_latency_stats.record(turn_latency);
+    return game_continues;
+}
 
-        // --- PROCESS VALID MOVE ---
-        std::string augmented_move = process_move(best_move_str);
+bool Game::apply_answer(const std::string &best_move_str, long long elapsed_ms,
+                        bool is_primary_game) {
+    Engine &current_engine = engine_to_move();
+    Engine &opponent_engine = (current_turn == Color::RED) ? black_engine : red_engine;
+
+    // --- FLAG FALL DURING THE SEARCH ---
+    if (current_engine.timed_out()) {
+        send_info_string(std::format("{} loses on time (no move within {} ms). {} wins.",
+                                     current_engine.get_name(), turn_deadline_ms,
+                                     opponent_engine.get_name()));
+        if (is_primary_game)
+            send_to_gui(
+                std::format("info result {}", (current_turn == Color::RED ? "0-1" : "1-0")));
+        return end_game((current_turn == Color::RED) ? Color::BLACK : Color::RED);
+    }
 
-        if (is_primary_game) {
-            send_to_gui(std::format("info move {} time {}", augmented_move, elapsed_ms));
-        }
+    // --- RESIGNATION / CRASH CHECK ---
+    if (best_move_str == "resign" || best_move_str.empty() || best_move_str == "(none)") {
+        std::string reason = "resigns or crashed";
+        if (best_move_str == "(none)") reason = "returned no move";
+
+        send_info_string(std::format("{} {}. {} wins.", current_engine.get_name(), reason,
+                                     opponent_engine.get_name()));
+        if (is_primary_game)
+            send_to_gui(
+                std::format("info result {}", (current_turn == Color::RED ? "0-1" : "1-0")));
+        return end_game((current_turn == Color::RED) ? Color::BLACK : Color::RED);
+    }
+
+    // --- ILLEGAL MOVE VALIDATION ---
+    if (!validator.is_move_legal(best_move_str, current_turn, board)) {
+        validator.is_move_legal(best_move_str, current_turn, board);
+        send_info_string(std::format("{} made an illegal move ({}). {} wins.",
+                                     current_engine.get_name(), best_move_str,
+                                     opponent_engine.get_name()));
+        if (is_primary_game)
+            send_to_gui(
+                std::format("info result {}", (current_turn == Color::RED ? "0-1" : "1-0")));
+        return end_game((current_turn == Color::RED) ? Color::BLACK : Color::RED);
+    }
 
-        add_move_to_histories(augmented_move, current_turn);
-
-        // Record notation entry (FEN must reflect next-to-move side)
-        NotationMoveEntry entry;
-        entry.type = "move";
-        entry.data = augmented_move;
-        entry.engineTime = elapsed_ms;
-        entry.hasEngineScore = current_engine.has_last_eval();
-        entry.engineScore = entry.hasEngineScore ? current_engine.get_last_eval_cp() : 0;
-
-        // Switch turn now so that generate_fen encodes the next side to move
-        current_turn = (current_turn == Color::RED) ? Color::BLACK : Color::RED;
-
-        entry.fen = generate_fen();
-        notation_moves.push_back(std::move(entry));
-
-        // --- CHECK FOR CHECKMATE/STALEMATE ---
-        if (validator.is_checkmate_or_stalemate(current_turn, board)) {
-            if (validator.is_in_check(current_turn, board)) {
-                // Checkmate
-                send_info_string(std::format("{} is in checkmate. {} wins.",
-                                             (current_turn == Color::RED ? "Red" : "Black"),
-                                             opponent_engine.get_name()));
-                if (is_primary_game)
-                    send_to_gui(std::format("info result {}",
-                                            (current_turn == Color::RED ? "0-1" : "1-0")));
-                return (current_turn == Color::RED) ? Color::BLACK : Color::RED;
-            } else {
-                // Stalemate
-                send_info_string(std::format("{} is stalemated. Game is a draw.",
-                                             (current_turn == Color::RED ? "Red" : "Black")));
-                if (is_primary_game) send_to_gui("info result 1/2-1/2");
-                return Color::NONE;
-            }
+    // --- TIME CHECK ---
+    if (time_manager) {
+        time_manager->update(current_turn, elapsed_ms);
+        if (time_manager->is_out_of_time(current_turn)) {
+            send_info_string(std::format("{} loses on time. {} wins.",
+                                         current_engine.get_name(),
+                                         opponent_engine.get_name()));
+            if (is_primary_game)
+                send_to_gui(std::format("info result {}",
+                                        (current_turn == Color::RED ? "0-1" : "1-0")));
+            return end_game((current_turn == Color::RED) ? Color::BLACK : Color::RED);
         }
+    }
 
-        // --- REPETITION CHECK ---
-        std::string fen_key =
-            generate_fen_board_part() + " " + (current_turn == Color::RED ? 'w' : 'b');
-        position_history[fen_key]++;
-        if (position_history[fen_key] >= 3) {
-            send_info_string("Game ends in a draw by 3-fold repetition.");
+    // --- PROCESS VALID MOVE ---
+    std::string augmented_move = process_move(best_move_str);
+
+    if (is_primary_game) {
+        send_to_gui(std::format("info move {} time {}", augmented_move, elapsed_ms));
+    }
+
+    add_move_to_histories(augmented_move, current_turn);
+
+    // Record notation entry (FEN must reflect next-to-move side)
+    NotationMoveEntry entry;
+    entry.type = "move";
+    entry.data = augmented_move;
+    entry.engineTime = elapsed_ms;
+    entry.hasEngineScore = current_engine.has_last_eval();
+    entry.engineScore = entry.hasEngineScore ? current_engine.get_last_eval_cp() : 0;
+    entry.side = current_turn;
+    const SearchInfo &info = current_engine.get_last_info();
+    entry.engineDepth = info.depth;
+    entry.engineSeldepth = info.seldepth;
+    entry.engineNodes = info.nodes;
+    entry.engineNps = info.nps;
+    entry.engineHashfull = info.hashfull;
+    entry.enginePv = current_engine.get_last_pv();
+
+    // Switch turn now so that generate_fen encodes the next side to move
+    current_turn = (current_turn == Color::RED) ? Color::BLACK : Color::RED;
+
+    entry.fen = generate_fen();
+    notation_moves.push_back(std::move(entry));
+
+    // --- CHECK FOR CHECKMATE/STALEMATE ---
+    if (validator.is_checkmate_or_stalemate(current_turn, board)) {
+        if (validator.is_in_check(current_turn, board)) {
+            // Checkmate
+            send_info_string(std::format("{} is in checkmate. {} wins.",
+                                         (current_turn == Color::RED ? "Red" : "Black"),
+                                         opponent_engine.get_name()));
+            if (is_primary_game)
+                send_to_gui(std::format("info result {}",
+                                        (current_turn == Color::RED ? "0-1" : "1-0")));
+            return end_game((current_turn == Color::RED) ? Color::BLACK : Color::RED);
+        } else {
+            // Stalemate
+            send_info_string(std::format("{} is stalemated. Game is a draw.",
+                                         (current_turn == Color::RED ? "Red" : "Black")));
             if (is_primary_game) send_to_gui("info result 1/2-1/2");
-            return Color::NONE;
+            return end_game(Color::NONE);
         }
     }
+
+    // --- REPETITION CHECK ---
+    if (record_position() >= 3) {
+        send_info_string("Game ends in a draw by 3-fold repetition.");
+        if (is_primary_game) send_to_gui("info result 1/2-1/2");
+        return end_game(Color::NONE);
+    }
+    return true;
 }
 
 // ... (generate_fen_board_part, generate_fen, process_move,
 // add_move_to_histories, get_moves_for_color remain the same) ...
 std::string Game::generate_fen_board_part() const {
-    std::stringstream ss;
-    for (int r = 0; r < 10; ++r) {
-        int empty_count = 0;
-        for (int c = 0; c < 9; ++c) {
-            Piece p = board[r][c];
-            if (p == Piece::EMPTY) {
-                empty_count++;
-            } else {
-                if (empty_count > 0) {
-                    ss << empty_count;
-                    empty_count = 0;
-                }
-                ss << piece_to_char.at(p);
-            }
-        }
-        if (empty_count > 0) {
-            ss << empty_count;
-        }
-        if (r < 9) {
-            ss << '/';
-        }
+    return board.fen_board();
+}
+
+std::uint64_t Game::position_key() const {
+    std::uint64_t key = board.key() ^ piece_pool.key();
+    return current_turn == Color::BLACK ? key ^ ZOBRIST.black_to_move : key;
+}
+
+int Game::record_position() {
+    std::uint64_t key = position_key();
+    key_history.push_back(key);
+
+    // Positions with the same side to move are two plies apart.
+    int count = 0;
+    for (int i = static_cast<int>(key_history.size()) - 1; i >= irreversible_ply; i -= 2) {
+        if (key_history[i] == key) count++;
     }
-    return ss.str();
+    return count;
 }
 
 // Generate the complete FEN string in the new format
@@ -257,14 +324,14 @@ std::string Game::process_move(const std::string &move_str) {
     if (moving_piece_type == Piece::HIDDEN) {
         flipped_piece = piece_pool.draw_random_piece(current_turn);
         if (flipped_piece) {
-            augmented_move += piece_to_char.at(*flipped_piece);
+            augmented_move += piece_to_char(*flipped_piece);
         } else {
             send_info_string(std::format("CRITICAL: Piece pool is empty for {}. Cannot flip.",
                                          (current_turn == Color::RED ? "Red" : "Black")));
             // As a fallback, maybe make it a pawn? This state should ideally not be
             // reached.
             flipped_piece = (current_turn == Color::RED) ? Piece::RED_PAWN : Piece::BLK_PAWN;
-            augmented_move += piece_to_char.at(*flipped_piece);
+            augmented_move += piece_to_char(*flipped_piece);
         }
     }
 
@@ -273,12 +340,18 @@ std::string Game::process_move(const std::string &move_str) {
         Color opponent_color = (current_turn == Color::RED) ? Color::BLACK : Color::RED;
         auto captured_hidden_piece = piece_pool.draw_random_piece(opponent_color);
         if (captured_hidden_piece) {
-            augmented_move += piece_to_char.at(*captured_hidden_piece);
+            augmented_move += piece_to_char(*captured_hidden_piece);
         } else {
             send_info_string("Warning: Opponent piece pool is empty for capture simulation.");
         }
     }
 
+    // Captures and flips change the position for good, so no earlier
+    // position can repeat after them.
+    if (moving_piece_type == Piece::HIDDEN || target_square_piece_type != Piece::EMPTY) {
+        irreversible_ply = static_cast<int>(key_history.size());
+    }
+
     // C. Update the internal board state with ground truth
     Piece final_moving_piece = flipped_piece.value_or(moving_piece_type);
     set_piece_at_coord(to_coord, final_moving_piece);
@@ -307,6 +380,50 @@ void Game::add_move_to_histories(const std::string &true_move, Color move_color)
     move_history_black.push_back(black_move);
 }
 
-std::vector<std::string> Game::get_moves_for_color(Color color) {
+const std::vector<std::string> &Game::get_moves_for_color(Color color) const {
     return (color == Color::RED) ? move_history_red : move_history_black;
-}
\ No newline at end of file
+}
+
+EngineGameStats Game::engine_stats(Color side) const {
+    EngineGameStats stats;
+    long long depth_sum = 0, seldepth_sum = 0;
+    double nps_sum = 0;
+    int depth_count = 0, seldepth_count = 0, nps_count = 0;
+    std::array<long long, EngineGameStats::PROFILE_BUCKETS> profile_time{};
+
+    for (const auto &entry : notation_moves) {
+        if (entry.type != "move" || entry.side != side) continue;
+
+        int bucket = std::min(stats.moves / EngineGameStats::PROFILE_BUCKET_MOVES,
+                              EngineGameStats::PROFILE_BUCKETS - 1);
+        stats.moves++;
+        stats.total_time_ms += entry.engineTime;
+        stats.profile_moves[bucket]++;
+        profile_time[bucket] += entry.engineTime;
+
+        if (entry.engineDepth >= 0) {
+            depth_sum += entry.engineDepth;
+            depth_count++;
+        }
+        if (entry.engineSeldepth >= 0) {
+            seldepth_sum += entry.engineSeldepth;
+            seldepth_count++;
+        }
+        if (entry.engineNps >= 0) {
+            nps_sum += static_cast<double>(entry.engineNps);
+            nps_count++;
+        }
+        if (entry.engineNodes >= 0) stats.total_nodes += entry.engineNodes;
+    }
+
+    if (depth_count) stats.avg_depth = static_cast<double>(depth_sum) / depth_count;
+    if (seldepth_count) stats.avg_seldepth = static_cast<double>(seldepth_sum) / seldepth_count;
+    if (nps_count) stats.avg_nps = nps_sum / nps_count;
+    for (int i = 0; i < EngineGameStats::PROFILE_BUCKETS; ++i) {
+        if (stats.profile_moves[i]) {
+            stats.profile_avg_time_ms[i] =
+                static_cast<double>(profile_time[i]) / stats.profile_moves[i];
+        }
+    }
+    return stats;
+}
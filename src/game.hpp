@@ -1,12 +1,18 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "board.hpp"
+#include "book_format.hpp"
 #include "engine.hpp"
+#include "latency.hpp"
 #include "move_validator.hpp"
 #include "piece_pool.hpp"
 #include "time_manager.hpp"
@@ -14,6 +20,9 @@
 
 // --- Game Logic ---
 
+// A game is drawn once this many plies have been played.
+constexpr int MAX_PLIES = 300;
+
 struct NotationMoveEntry {
     std::string type;     // "move" or "adjust"
     std::string data;     // UCI move or adjustment
@@ -22,6 +31,31 @@ struct NotationMoveEntry {
     int engineScore = 0;  // centipawns; mate as +/- (30000 - ply)
     long long engineTime = 0;  // ms
     bool hasEngineScore = false;  // whether engineScore is valid
+    Color side = Color::NONE;     // who made the move
+
+    // Last values the engine reported before bestmove; -1 / empty if none
+    int engineDepth = -1;
+    int engineSeldepth = -1;
+    std::int64_t engineNodes = -1;
+    std::int64_t engineNps = -1;
+    int engineHashfull = -1;
+    std::string enginePv;
+};
+
+// Summary of one engine's search statistics over a game.
+struct EngineGameStats {
+    // Think time is profiled over buckets of 10 moves: 1-10, ..., 41-50, 51+.
+    static constexpr int PROFILE_BUCKET_MOVES = 10;
+    static constexpr int PROFILE_BUCKETS = 6;
+
+    int moves = 0;
+    double avg_depth = 0;     // Over moves that reported the value
+    double avg_seldepth = 0;
+    double avg_nps = 0;
+    std::int64_t total_nodes = 0;
+    long long total_time_ms = 0;
+    std::array<int, PROFILE_BUCKETS> profile_moves{};
+    std::array<double, PROFILE_BUCKETS> profile_avg_time_ms{};
 };
 
 class Game {
@@ -32,7 +66,7 @@ class Game {
     MoveValidator validator;
 
     PiecePool piece_pool;
-    std::vector<std::vector<Piece>> board;  // 10 rows, 9 columns
+    Board board;
     Color current_turn = Color::RED;
 
     // Three different move histories for different perspectives
@@ -40,27 +74,57 @@ class Game {
     std::vector<std::string> move_history_red;    // Red's view - hides Black's hidden captures
     std::vector<std::string> move_history_black;  // Black's view - hides Red's hidden captures
 
-    // Map to store position history for 3-fold repetition check.
-    // Key is a FEN string representing the board and side to move.
-    std::map<std::string, int> position_history;
+    // Zobrist keys of every position since the start of the game, for the
+    // 3-fold repetition check. Positions before the last capture or flip can
+    // never recur, so only keys from `irreversible_ply` onwards are scanned.
+    std::vector<std::uint64_t> key_history;
+    int irreversible_ply = 0;
 
     std::optional<TimeManager> time_manager;
 
     // Notation entries for saving
     std::vector<NotationMoveEntry> notation_moves;
 
+    // State of the turn in progress
+    int move_count = 0;
+    int turn_deadline_ms = 0;
+    std::chrono::steady_clock::time_point turn_start;  // When go was sent
+    MoveLatency turn_latency;
+    Color game_result = Color::NONE;
+
    public:
     Game(Engine &r_eng, Engine &b_eng, std::string_view fen,
          std::optional<TimeControl> tc = std::nullopt, int timeout_buffer_ms = 5000);
+    // Starts from a validated binary book position instead of a FEN.
+    Game(Engine &r_eng, Engine &b_eng, const BookRecord &start,
+         std::optional<TimeControl> tc = std::nullopt, int timeout_buffer_ms = 5000);
 
     // Parses the full FEN string to set up the board and piece pool.
     void parse_fen(std::string_view fen);
+    // Sets up the board, side to move and piece pool from a book record.
+    void load_book_record(const BookRecord &record);
+    // Key of the random stream that decides flips and hidden captures; the
+    // same key and moves give the same game.
+    void set_flip_key(std::uint64_t key) { piece_pool.set_random_key(key); }
     Piece get_piece_at_coord(const std::string &coord);
     void set_piece_at_coord(const std::string &coord, Piece p);
 
     // Added is_primary_game parameter
     Color run(bool is_primary_game);
 
+    // Step-wise interface behind run(), for schedulers that drive many games
+    // from one thread. begin_turn() sends the position and go command to the
+    // engine to move; end_turn() applies its answer ("" if the search was
+    // aborted, "resign" if the engine died). Both return false once the game
+    // is over, and result() then holds the outcome.
+    bool begin_turn(bool is_primary_game);
+    bool end_turn(const std::string &best_move_str, bool is_primary_game);
+    Color result() const { return game_result; }
+
+    // The engine whose turn it is, and how long its search may take.
+    Engine &engine_to_move();
+    int get_turn_deadline_ms() const { return turn_deadline_ms; }
+
     // Generate the complete FEN string in the new format
     std::string generate_fen() const;
 
@@ -73,12 +137,29 @@ class Game {
     // Notation export
     const std::vector<NotationMoveEntry> &get_notation_moves() const { return notation_moves; }
 
+    // Aggregates the recorded search statistics of the engine playing `side`.
+    EngineGameStats engine_stats(Color side) const;
+
    private:
-    // Generates the board and turn part of a FEN string for repetition checks.
+    // Generates the board part of a FEN string.
     std::string generate_fen_board_part() const;
+
+    // Zobrist key of the current position: board, piece pool and side to move.
+    std::uint64_t position_key() const;
+    // Appends the current position to the key history and returns how many
+    // times it has occurred since the last irreversible move.
+    int record_position();
     std::string process_move(const std::string &move_str);
+    // Body of end_turn(): checks and plays the engine's answer, charging it
+    // `elapsed_ms` of thinking time.
+    bool apply_answer(const std::string &best_move_str, long long elapsed_ms,
+                      bool is_primary_game);
+    // Starts the repetition history at the position just set up.
+    void reset_position_history();
+    // Records the outcome and returns false, for begin_turn()/end_turn().
+    bool end_game(Color result);
 
     // Helper functions for managing move histories
     void add_move_to_histories(const std::string &true_move, Color move_color);
-    std::vector<std::string> get_moves_for_color(Color color);
+    const std::vector<std::string> &get_moves_for_color(Color color) const;
 };
\ No newline at end of file
@@ -0,0 +1,357 @@
+#include "game_archive.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <system_error>
+
+#include "block_compression.hpp"
+
+namespace {
+
+// A block is written once it holds this much, or once it is this old.
+constexpr size_t BLOCK_BYTES = 256 * 1024;
+constexpr auto BLOCK_INTERVAL = std::chrono::seconds(1);
+
+std::uint32_t fnv1a(std::string_view data) {
+    std::uint32_t hash = 2166136261u;
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::string index_path(const std::string &archive_path) {
+    return archive_path + ".idx";
+}
+
+bool has_magic(std::string_view data, const char (&magic)[8]) {
+    return data.size() >= sizeof(ArchiveFileHeader) &&
+           std::memcmp(data.data(), magic, sizeof(magic)) == 0;
+}
+
+ArchiveFileHeader file_header(const char (&magic)[8]) {
+    ArchiveFileHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = ARCHIVE_VERSION;
+    return header;
+}
+
+// Size of the block at `offset` including its header, or 0 if it does not
+// fit in `data`.
+std::uint64_t block_extent(std::string_view data, std::uint64_t offset) {
+    if (offset + sizeof(ArchiveBlockHeader) > data.size()) return 0;
+    ArchiveBlockHeader header;
+    std::memcpy(&header, data.data() + offset, sizeof(header));
+    std::uint64_t extent = sizeof(header) + header.stored_size;
+    return offset + extent <= data.size() ? extent : 0;
+}
+
+// Reads and checks the block at `offset`, uncompressed into `raw`.
+bool read_block(std::string_view data, std::uint64_t offset, std::string &raw,
+                ArchiveBlockHeader &header, std::string &error) {
+    if (block_extent(data, offset) == 0) {
+        error = std::format("block at offset {} is truncated", offset);
+        return false;
+    }
+    std::memcpy(&header, data.data() + offset, sizeof(header));
+    std::string_view stored = data.substr(offset + sizeof(header), header.stored_size);
+    if (fnv1a(stored) != header.checksum) {
+        error = std::format("block at offset {} is corrupt", offset);
+        return false;
+    }
+    if (header.flags & ARCHIVE_BLOCK_COMPRESSED) {
+        if (!decompress_block(stored, header.raw_size, raw)) {
+            error = std::format("block at offset {} does not decompress", offset);
+            return false;
+        }
+    } else {
+        raw.assign(stored);
+    }
+    return true;
+}
+
+// Indexes the complete blocks from `offset` on, stopping at the first one
+// that is truncated or corrupt. Returns the offset after the last good block.
+std::uint64_t scan_blocks(std::string_view data, std::uint64_t offset,
+                          std::vector<ArchiveIndexEntry> &entries) {
+    std::string raw, error;
+    ArchiveBlockHeader header;
+    GameRecord record;
+    while (read_block(data, offset, raw, header, error)) {
+        std::vector<ArchiveIndexEntry> found;
+        for (size_t pos = 0; pos + sizeof(std::uint32_t) <= raw.size();) {
+            std::uint32_t size;
+            std::memcpy(&size, raw.data() + pos, sizeof(size));
+            pos += sizeof(size);
+            if (size > raw.size() - pos ||
+                !decode_game_record(std::string_view(raw).substr(pos, size), record)) {
+                break;
+            }
+            found.push_back({record.game_id, offset, static_cast<std::uint32_t>(pos), size});
+            pos += size;
+        }
+        if (found.size() != header.record_count) break;
+        entries.insert(entries.end(), found.begin(), found.end());
+        offset += block_extent(data, offset);
+    }
+    return offset;
+}
+
+// Entries of the index file at `path`, without a trailing partial entry.
+std::vector<ArchiveIndexEntry> load_index(const std::string &path) {
+    std::vector<ArchiveIndexEntry> entries;
+    MappedFile file;
+    if (!file.open(path) || !has_magic(file.view(), ARCHIVE_INDEX_MAGIC)) return entries;
+    size_t count = (file.size() - sizeof(ArchiveFileHeader)) / sizeof(ArchiveIndexEntry);
+    entries.resize(count);
+    std::memcpy(entries.data(), file.data() + sizeof(ArchiveFileHeader),
+                count * sizeof(ArchiveIndexEntry));
+    return entries;
+}
+
+// Drops index entries whose block is not complete in `data`, then indexes the
+// complete blocks after the last indexed one. Returns where the good part of
+// the archive ends.
+std::uint64_t recover_index(std::string_view data, std::vector<ArchiveIndexEntry> &entries) {
+    while (!entries.empty() && block_extent(data, entries.back().block_offset) == 0) {
+        entries.pop_back();
+    }
+    std::uint64_t end = sizeof(ArchiveFileHeader);
+    if (!entries.empty()) {
+        end = entries.back().block_offset + block_extent(data, entries.back().block_offset);
+    }
+    return scan_blocks(data, end, entries);
+}
+
+}  // namespace
+
+// --- GameArchiveWriter ---
+
+GameArchiveWriter::~GameArchiveWriter() {
+    close();
+}
+
+bool GameArchiveWriter::open(NotationFormat format_, const std::string &path_, bool compress_,
+                             std::string &error) {
+    close();
+    written = 0;
+    failed = 0;
+    format = format_;
+    path = path_;
+    compress = compress_;
+    block.clear();
+    block_entries.clear();
+
+    std::error_code ec;
+    std::filesystem::path directory = format == NotationFormat::JSON
+                                          ? std::filesystem::path(path)
+                                          : std::filesystem::path(path).parent_path();
+    if (!directory.empty()) std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        error = std::format("Cannot create directory {}: {}", directory.string(), ec.message());
+        return false;
+    }
+    if (format == NotationFormat::ARCHIVE && !open_archive(error)) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    running = true;
+    stopping = false;
+    thread = std::thread([this] { run(); });
+    return true;
+}
+
+bool GameArchiveWriter::open_archive(std::string &error) {
+    std::vector<ArchiveIndexEntry> entries = load_index(index_path(path));
+    std::uint64_t end = 0;
+    {
+        MappedFile existing;
+        if (existing.open(path) && existing.size() > 0) {
+            if (!has_magic(existing.view(), ARCHIVE_MAGIC)) {
+                error = std::format("{} exists and is not a game archive", path);
+                return false;
+            }
+            end = recover_index(existing.view(), entries);
+        }
+    }
+
+    std::error_code ec;
+    if (end > 0) {
+        // Cut off a block the last writer did not finish.
+        if (std::filesystem::file_size(path, ec) > end) std::filesystem::resize_file(path, end, ec);
+        archive.open(path, std::ios::binary | std::ios::app);
+    } else {
+        ArchiveFileHeader header = file_header(ARCHIVE_MAGIC);
+        archive.open(path, std::ios::binary | std::ios::trunc);
+        archive.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        end = sizeof(header);
+        entries.clear();
+    }
+    archive_size = end;
+
+    // The index is small, so it is simply rewritten to match the archive.
+    ArchiveFileHeader header = file_header(ARCHIVE_INDEX_MAGIC);
+    index.open(index_path(path), std::ios::binary | std::ios::trunc);
+    index.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    index.write(reinterpret_cast<const char *>(entries.data()),
+                static_cast<std::streamsize>(entries.size() * sizeof(ArchiveIndexEntry)));
+    archive.flush();
+    index.flush();
+
+    if (ec || !archive || !index) {
+        error = std::format("Cannot write game archive {}", path);
+        archive.close();
+        index.close();
+        return false;
+    }
+    return true;
+}
+
+void GameArchiveWriter::submit(GameRecord record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            failed++;
+            return;
+        }
+        queue.push_back(std::move(record));
+    }
+    wake.notify_one();
+}
+
+void GameArchiveWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+    archive.close();
+    index.close();
+}
+
+void GameArchiveWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait_for(lock, BLOCK_INTERVAL, [this] { return stopping || !queue.empty(); });
+        // Read before taking the queue, so that games queued before close()
+        // are still written.
+        bool done = stopping;
+        std::vector<GameRecord> batch;
+        batch.swap(queue);
+        lock.unlock();
+
+        for (const GameRecord &record : batch) add(record);
+        if (done || (!block.empty() && Clock::now() - block_started >= BLOCK_INTERVAL)) {
+            write_block();
+        }
+
+        lock.lock();
+        if (done && queue.empty()) break;
+    }
+}
+
+void GameArchiveWriter::add(const GameRecord &record) {
+    if (format == NotationFormat::JSON) {
+        write_json(record);
+        return;
+    }
+
+    if (block.empty()) block_started = Clock::now();
+    size_t size_pos = block.size();
+    block.resize(size_pos + sizeof(std::uint32_t));
+    encode_game_record(record, block);
+    auto size = static_cast<std::uint32_t>(block.size() - size_pos - sizeof(std::uint32_t));
+    std::memcpy(block.data() + size_pos, &size, sizeof(size));
+    block_entries.push_back(
+        {record.game_id, 0, static_cast<std::uint32_t>(size_pos + sizeof(size)), size});
+
+    if (block.size() >= BLOCK_BYTES) write_block();
+}
+
+void GameArchiveWriter::write_block() {
+    if (block_entries.empty()) return;
+
+    ArchiveBlockHeader header{};
+    header.raw_size = static_cast<std::uint32_t>(block.size());
+    header.record_count = static_cast<std::uint32_t>(block_entries.size());
+    std::string compressed;
+    if (compress) compressed = compress_block(block);
+    bool use_compressed = compress && compressed.size() < block.size();
+    std::string_view stored = use_compressed ? compressed : block;
+    header.stored_size = static_cast<std::uint32_t>(stored.size());
+    header.flags = use_compressed ? ARCHIVE_BLOCK_COMPRESSED : 0;
+    header.checksum = fnv1a(stored);
+
+    archive.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    archive.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+    archive.flush();
+    if (archive) {
+        for (ArchiveIndexEntry &entry : block_entries) entry.block_offset = archive_size;
+        index.write(reinterpret_cast<const char *>(block_entries.data()),
+                    static_cast<std::streamsize>(block_entries.size() * sizeof(ArchiveIndexEntry)));
+        index.flush();
+        archive_size += sizeof(header) + stored.size();
+        written += block_entries.size();
+    } else {
+        failed += block_entries.size();
+    }
+    block.clear();
+    block_entries.clear();
+}
+
+void GameArchiveWriter::write_json(const GameRecord &record) {
+    std::string filename = std::format("{}/game_{}.json", path, record.game_id);
+    std::ofstream ofs(filename, std::ios::out | std::ios::trunc);
+    if (ofs) write_jieqibox_json(ofs, record);
+    if (ofs) {
+        written++;
+    } else {
+        failed++;
+    }
+}
+
+// --- GameArchiveReader ---
+
+bool GameArchiveReader::open(const std::string &path, std::string &error) {
+    entries.clear();
+    cached_block = UINT64_MAX;
+    if (!file.open(path)) {
+        error = std::format("Cannot open {}", path);
+        return false;
+    }
+    if (!has_magic(file.view(), ARCHIVE_MAGIC)) {
+        error = std::format("{} is not a game archive", path);
+        return false;
+    }
+    entries = load_index(index_path(path));
+    recover_index(file.view(), entries);
+    return true;
+}
+
+std::optional<size_t> GameArchiveReader::find(std::int64_t game_id) const {
+    for (size_t i = entries.size(); i-- > 0;) {
+        if (entries[i].game_id == game_id) return i;
+    }
+    return std::nullopt;
+}
+
+bool GameArchiveReader::read(size_t i, GameRecord &record, std::string &error) const {
+    const ArchiveIndexEntry &e = entries[i];
+    if (cached_block != e.block_offset) {
+        ArchiveBlockHeader header;
+        cached_block = UINT64_MAX;
+        if (!read_block(file.view(), e.block_offset, cached_raw, header, error)) return false;
+        cached_block = e.block_offset;
+    }
+    if (static_cast<std::uint64_t>(e.record_offset) + e.record_size > cached_raw.size() ||
+        !decode_game_record(std::string_view(cached_raw).substr(e.record_offset, e.record_size),
+                            record)) {
+        error = std::format("game {} is corrupt", e.game_id);
+        return false;
+    }
+    return true;
+}
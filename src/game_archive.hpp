@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_record.hpp"
+#include "mapped_file.hpp"
+
+// --- Game Archive ---
+// Finished games are appended to a single archive file as blocks of encoded
+// GameRecords (see game_record.hpp), each block compressed unless that does
+// not make it smaller. `<archive>.idx` holds one fixed-size entry per game
+// with the offset of its block and its place in the block, so any game can
+// be read without scanning the archive.
+//
+// Both files are only appended to. A block is written before the index
+// entries that point to it, and opening an archive for writing cuts off a
+// block left incomplete by a crash and re-indexes complete blocks the index
+// is missing.
+
+struct ArchiveFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(ArchiveFileHeader) == 16);
+
+// Followed by `stored_size` bytes of data. Uncompressed, the data is the
+// block's records, each preceded by its size as a 32-bit integer.
+struct ArchiveBlockHeader {
+    std::uint32_t raw_size;     // Size of the uncompressed data
+    std::uint32_t stored_size;  // Size of the data in the file
+    std::uint32_t record_count;
+    std::uint32_t flags;     // ARCHIVE_BLOCK_COMPRESSED
+    std::uint32_t checksum;  // FNV-1a of the stored data
+    std::uint32_t reserved;
+};
+static_assert(sizeof(ArchiveBlockHeader) == 24);
+
+struct ArchiveIndexEntry {
+    std::int64_t game_id;
+    std::uint64_t block_offset;   // Of the block header in the archive
+    std::uint32_t record_offset;  // Of the record in the uncompressed block
+    std::uint32_t record_size;
+};
+static_assert(sizeof(ArchiveIndexEntry) == 24);
+
+constexpr char ARCHIVE_MAGIC[8] = {'J', 'Q', 'A', 'R', 'C', 'H', '0', '1'};
+constexpr char ARCHIVE_INDEX_MAGIC[8] = {'J', 'Q', 'A', 'R', 'I', 'D', 'X', '1'};
+constexpr std::uint32_t ARCHIVE_VERSION = 1;
+constexpr std::uint32_t ARCHIVE_BLOCK_COMPRESSED = 1;
+
+enum class NotationFormat { ARCHIVE, JSON };
+
+// Writes finished games on a background thread. Workers only queue the
+// record, so a game never waits for the disk. ARCHIVE appends the games to
+// an archive; JSON writes one JieqiBox file per game into a directory.
+//
+// Records are collected into a block until it holds 256 KB or is a second
+// old, so a crash loses at most the last second of games.
+class GameArchiveWriter {
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<GameRecord> queue;
+    bool running = false;
+    bool stopping = false;
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> failed{0};
+
+    // Writer thread only
+    NotationFormat format = NotationFormat::ARCHIVE;
+    std::string path;
+    bool compress = true;
+    std::ofstream archive;
+    std::ofstream index;
+    std::uint64_t archive_size = 0;
+    std::string block;  // Records of the block being collected
+    std::vector<ArchiveIndexEntry> block_entries;
+    Clock::time_point block_started;
+
+    std::thread thread;
+
+    bool open_archive(std::string &error);
+    void run();
+    void add(const GameRecord &record);
+    void write_block();
+    void write_json(const GameRecord &record);
+
+   public:
+    GameArchiveWriter() = default;
+    ~GameArchiveWriter();
+    GameArchiveWriter(const GameArchiveWriter &) = delete;
+    GameArchiveWriter &operator=(const GameArchiveWriter &) = delete;
+
+    // Starts writing to `path`: the archive file for ARCHIVE, the directory
+    // for JSON. An existing archive is appended to. Returns false with
+    // `error` set if the files cannot be created.
+    bool open(NotationFormat format, const std::string &path, bool compress,
+              std::string &error);
+
+    // Queues a finished game. Games submitted while not open are counted as
+    // failed.
+    void submit(GameRecord record);
+
+    // Writes everything queued and stops the writer thread.
+    void close();
+
+    std::uint64_t games_written() const { return written; }
+    std::uint64_t games_failed() const { return failed; }
+};
+
+// Random access to the games of an archive.
+class GameArchiveReader {
+   private:
+    MappedFile file;
+    std::vector<ArchiveIndexEntry> entries;
+    // Last block read, as export reads the games of a block in a row.
+    mutable std::uint64_t cached_block = UINT64_MAX;
+    mutable std::string cached_raw;
+
+   public:
+    // Opens an archive and its index. Games of blocks the index lacks are
+    // found by scanning the end of the archive.
+    bool open(const std::string &path, std::string &error);
+
+    size_t size() const { return entries.size(); }
+    const ArchiveIndexEntry &entry(size_t i) const { return entries[i]; }
+
+    // The last game stored with `game_id`, if any.
+    std::optional<size_t> find(std::int64_t game_id) const;
+
+    bool read(size_t i, GameRecord &record, std::string &error) const;
+};
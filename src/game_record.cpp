@@ -0,0 +1,282 @@
+#include "game_record.hpp"
+
+#include <cstring>
+#include <format>
+
+namespace {
+
+// First byte of every encoded record; bump when the encoding changes.
+constexpr std::uint8_t RECORD_VERSION = 1;
+
+class RecordWriter {
+   private:
+    std::string &out;
+
+   public:
+    explicit RecordWriter(std::string &out) : out(out) {}
+
+    void byte(std::uint8_t value) { out += static_cast<char>(value); }
+    void unsigned_int(std::uint64_t value) {
+        while (value >= 0x80) {
+            byte(static_cast<std::uint8_t>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        byte(static_cast<std::uint8_t>(value));
+    }
+    // Zigzag encoding keeps small negative values (the -1 "not reported") short.
+    void signed_int(std::int64_t value) {
+        unsigned_int((static_cast<std::uint64_t>(value) << 1) ^
+                     static_cast<std::uint64_t>(value >> 63));
+    }
+    void real(double value) {
+        char bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(bytes));
+        out.append(bytes, sizeof(bytes));
+    }
+    void text(std::string_view value) {
+        unsigned_int(value.size());
+        out.append(value);
+    }
+};
+
+// Reads what RecordWriter wrote; every read fails once the data runs out.
+class RecordReader {
+   private:
+    std::string_view data;
+    bool ok = true;
+
+   public:
+    explicit RecordReader(std::string_view data) : data(data) {}
+
+    bool good() const { return ok; }
+    bool at_end() const { return data.empty(); }
+
+    std::uint8_t byte() {
+        if (data.empty()) {
+            ok = false;
+            return 0;
+        }
+        auto value = static_cast<std::uint8_t>(data.front());
+        data.remove_prefix(1);
+        return value;
+    }
+    std::uint64_t unsigned_int() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64 && ok; shift += 7) {
+            std::uint8_t b = byte();
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    std::int64_t signed_int() {
+        std::uint64_t value = unsigned_int();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+    double real() {
+        double value = 0;
+        if (data.size() < sizeof(double)) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data.data(), sizeof(double));
+        data.remove_prefix(sizeof(double));
+        return value;
+    }
+    std::string text() {
+        std::uint64_t size = unsigned_int();
+        if (!ok || size > data.size()) {
+            ok = false;
+            return {};
+        }
+        std::string value(data.substr(0, size));
+        data.remove_prefix(size);
+        return value;
+    }
+};
+
+std::string json_escape(const std::string &s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u";
+                    const char *hex = "0123456789abcdef";
+                    out += hex[(c >> 12) & 0xF];
+                    out += hex[(c >> 8) & 0xF];
+                    out += hex[(c >> 4) & 0xF];
+                    out += hex[c & 0xF];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+void encode_game_record(const GameRecord &record, std::string &out) {
+    RecordWriter w(out);
+    w.byte(RECORD_VERSION);
+    w.signed_int(record.game_id);
+    w.unsigned_int(record.seed);
+    w.text(record.date);
+    w.text(record.red_name);
+    w.text(record.black_name);
+    w.text(record.result);
+    w.text(record.initial_fen);
+    w.text(record.current_fen);
+
+    w.unsigned_int(record.moves.size());
+    for (const NotationMoveEntry &m : record.moves) {
+        w.text(m.type);
+        w.text(m.data);
+        w.text(m.comment);
+        w.text(m.fen);
+        w.signed_int(m.engineScore);
+        w.signed_int(m.engineTime);
+        w.byte(m.hasEngineScore ? 1 : 0);
+        w.byte(static_cast<std::uint8_t>(m.side));
+        w.signed_int(m.engineDepth);
+        w.signed_int(m.engineSeldepth);
+        w.signed_int(m.engineNodes);
+        w.signed_int(m.engineNps);
+        w.signed_int(m.engineHashfull);
+        w.text(m.enginePv);
+    }
+
+    for (const EngineGameStats &s : record.stats) {
+        w.signed_int(s.moves);
+        w.real(s.avg_depth);
+        w.real(s.avg_seldepth);
+        w.real(s.avg_nps);
+        w.signed_int(s.total_nodes);
+        w.signed_int(s.total_time_ms);
+        for (int b = 0; b < EngineGameStats::PROFILE_BUCKETS; ++b) {
+            w.signed_int(s.profile_moves[b]);
+            w.real(s.profile_avg_time_ms[b]);
+        }
+    }
+}
+
+bool decode_game_record(std::string_view data, GameRecord &record) {
+    RecordReader r(data);
+    if (r.byte() != RECORD_VERSION) return false;
+    record.game_id = static_cast<int>(r.signed_int());
+    record.seed = r.unsigned_int();
+    record.date = r.text();
+    record.red_name = r.text();
+    record.black_name = r.text();
+    record.result = r.text();
+    record.initial_fen = r.text();
+    record.current_fen = r.text();
+
+    std::uint64_t move_count = r.unsigned_int();
+    // Every move takes at least a few bytes, which bounds a corrupt count.
+    if (!r.good() || move_count > data.size()) return false;
+    record.moves.assign(move_count, NotationMoveEntry{});
+    for (NotationMoveEntry &m : record.moves) {
+        m.type = r.text();
+        m.data = r.text();
+        m.comment = r.text();
+        m.fen = r.text();
+        m.engineScore = static_cast<int>(r.signed_int());
+        m.engineTime = r.signed_int();
+        m.hasEngineScore = r.byte() != 0;
+        m.side = static_cast<Color>(r.byte());
+        m.engineDepth = static_cast<int>(r.signed_int());
+        m.engineSeldepth = static_cast<int>(r.signed_int());
+        m.engineNodes = r.signed_int();
+        m.engineNps = r.signed_int();
+        m.engineHashfull = static_cast<int>(r.signed_int());
+        m.enginePv = r.text();
+    }
+
+    for (EngineGameStats &s : record.stats) {
+        s.moves = static_cast<int>(r.signed_int());
+        s.avg_depth = r.real();
+        s.avg_seldepth = r.real();
+        s.avg_nps = r.real();
+        s.total_nodes = r.signed_int();
+        s.total_time_ms = r.signed_int();
+        for (int b = 0; b < EngineGameStats::PROFILE_BUCKETS; ++b) {
+            s.profile_moves[b] = static_cast<int>(r.signed_int());
+            s.profile_avg_time_ms[b] = r.real();
+        }
+    }
+    return r.good() && r.at_end();
+}
+
+void write_jieqibox_json(std::ostream &ofs, const GameRecord &record) {
+    ofs << "{\n";
+    ofs << "  \"metadata\": {\n";
+    ofs << "    \"event\": \"Jieqi Game\",\n";
+    ofs << "    \"site\": \"jieqibox\",\n";
+    ofs << "    \"date\": \"" << json_escape(record.date) << "\",\n";
+    ofs << "    \"round\": \"" << record.game_id << "\",\n";
+    ofs << "    \"white\": \"" << json_escape(record.red_name) << "\",\n";
+    ofs << "    \"black\": \"" << json_escape(record.black_name) << "\",\n";
+    ofs << "    \"result\": \"" << record.result << "\",\n";
+    ofs << "    \"initialFen\": \"" << json_escape(record.initial_fen) << "\",\n";
+    ofs << "    \"flipMode\": \"random\",\n";
+    ofs << "    \"currentFen\": \"" << json_escape(record.current_fen) << "\"\n";
+    ofs << "  },\n";
+
+    // Moves
+    ofs << "  \"moves\": [\n";
+    const auto &moves = record.moves;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const auto &m = moves[i];
+        ofs << "    {\n";
+        ofs << "      \"type\": \"" << json_escape(m.type) << "\",\n";
+        ofs << "      \"data\": \"" << json_escape(m.data) << "\",\n";
+        ofs << "      \"fen\": \"" << json_escape(m.fen) << "\"";
+        // Optional engine fields
+        ofs << ",\n      \"engineScore\": " << (m.hasEngineScore ? m.engineScore : 0);
+        ofs << ",\n      \"engineTime\": " << m.engineTime;
+        // Search statistics, only when the engine reported them
+        if (m.engineDepth >= 0) ofs << ",\n      \"engineDepth\": " << m.engineDepth;
+        if (m.engineSeldepth >= 0) ofs << ",\n      \"engineSeldepth\": " << m.engineSeldepth;
+        if (m.engineNodes >= 0) ofs << ",\n      \"engineNodes\": " << m.engineNodes;
+        if (m.engineNps >= 0) ofs << ",\n      \"engineNps\": " << m.engineNps;
+        if (m.engineHashfull >= 0) ofs << ",\n      \"engineHashfull\": " << m.engineHashfull;
+        if (!m.enginePv.empty())
+            ofs << ",\n      \"enginePv\": \"" << json_escape(m.enginePv) << "\"";
+        ofs << "\n    }";
+        if (i + 1 < moves.size()) ofs << ",";
+        ofs << "\n";
+    }
+    ofs << "  ],\n";
+
+    // Per-engine aggregates
+    ofs << "  \"stats\": {\n";
+    for (int side = 0; side < 2; ++side) {
+        const EngineGameStats &stats = record.stats[side];
+        ofs << "    \"" << (side == 0 ? "red" : "black") << "\": {\n";
+        ofs << "      \"moves\": " << stats.moves << ",\n";
+        ofs << std::format("      \"avgDepth\": {:.2f},\n", stats.avg_depth);
+        ofs << std::format("      \"avgSeldepth\": {:.2f},\n", stats.avg_seldepth);
+        ofs << std::format("      \"avgNps\": {:.0f},\n", stats.avg_nps);
+        ofs << "      \"totalNodes\": " << stats.total_nodes << ",\n";
+        ofs << "      \"totalTime\": " << stats.total_time_ms << ",\n";
+        ofs << "      \"timeProfile\": [";
+        for (int b = 0; b < EngineGameStats::PROFILE_BUCKETS; ++b) {
+            ofs << std::format("{}{{\"fromMove\": {}, \"moves\": {}, \"avgTime\": {:.1f}}}",
+                               b ? ", " : "", b * EngineGameStats::PROFILE_BUCKET_MOVES + 1,
+                               stats.profile_moves[b], stats.profile_avg_time_ms[b]);
+        }
+        ofs << "]\n";
+        ofs << "    }" << (side == 0 ? "," : "") << "\n";
+    }
+    ofs << "  }\n";
+    ofs << "}\n";
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game.hpp"
+
+// --- Game Records ---
+// Everything the notation of a finished game contains, detached from the
+// Game so it can be handed to the archive writer thread. Records are stored
+// in a compact binary encoding and turned into JieqiBox JSON only on export.
+
+struct GameRecord {
+    int game_id = 0;
+    std::uint64_t seed = 0;  // Seed of the match the game was played in
+    std::string date;        // YYYY-MM-DD
+    std::string red_name;
+    std::string black_name;
+    std::string result;  // "1-0", "0-1" or "1/2-1/2"
+    std::string initial_fen;
+    std::string current_fen;
+    std::vector<NotationMoveEntry> moves;
+    std::array<EngineGameStats, 2> stats;  // Red, then Black
+};
+
+// Appends the binary encoding of `record` to `out`.
+void encode_game_record(const GameRecord &record, std::string &out);
+
+// Decodes a record written by encode_game_record. Returns false if `data` is
+// truncated or not a record.
+bool decode_game_record(std::string_view data, GameRecord &record);
+
+// Writes the record as the JSON notation file JieqiBox reads.
+void write_jieqibox_json(std::ostream &out, const GameRecord &record);
@@ -0,0 +1,133 @@
+#include "game_scheduler.hpp"
+
+#include <algorithm>
+
+// --- WorkDeque ---
+// The memory orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+
+void WorkDeque::push(std::int64_t round) {
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    items[b & (CAPACITY - 1)].store(round, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+std::int64_t WorkDeque::pop() {
+    std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return EMPTY;
+    }
+    std::int64_t round = items[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // Last item: race the thieves for it.
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            round = EMPTY;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return round;
+}
+
+std::int64_t WorkDeque::steal() {
+    std::int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return EMPTY;
+
+    std::int64_t round = items[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+        return RETRY;
+    }
+    return round;
+}
+
+// --- GameScheduler ---
+
+void GameScheduler::start(std::int64_t rounds, int workers_in_match,
+                          std::vector<bool> finished_games) {
+    worker_count = std::max(workers_in_match, 1);
+    workers = std::make_unique<Worker[]>(worker_count);
+    total_rounds = rounds;
+    finished = std::move(finished_games);
+    next_round = 0;
+    stopped = false;
+}
+
+void GameScheduler::stop() {
+    stopped = true;
+}
+
+bool GameScheduler::next(int worker_id, std::int64_t &game) {
+    if (stopped || !workers) return false;
+    Worker &worker = workers[worker_id % worker_count];
+
+    while (true) {
+        if (worker.pending_game >= 0) {
+            game = worker.pending_game;
+            worker.pending_game = -1;
+            if (!is_finished(game)) return true;
+        }
+
+        std::int64_t round = worker.rounds.pop();
+        if (round == WorkDeque::EMPTY && refill(worker)) {
+            round = worker.rounds.pop();
+        }
+        if (round == WorkDeque::EMPTY) {
+            round = steal_round(worker_id % worker_count);
+        }
+        if (round == WorkDeque::EMPTY) return false;
+
+        // Games of a resumed match that were already played are passed over.
+        game = round * 2;
+        worker.pending_game = round * 2 + 1;
+        if (!is_finished(game)) return true;
+    }
+}
+
+bool GameScheduler::take_pending(int worker_id, std::int64_t &game) {
+    if (!workers) return false;
+    Worker &worker = workers[worker_id % worker_count];
+    game = worker.pending_game;
+    worker.pending_game = -1;
+    return game >= 0 && !is_finished(game);
+}
+
+bool GameScheduler::refill(Worker &worker) {
+    // Large batches while there is plenty left keep the counter cold; small
+    // ones towards the end leave less work stranded in a single deque.
+    std::int64_t remaining = total_rounds - next_round.load(std::memory_order_relaxed);
+    std::int64_t batch = std::clamp<std::int64_t>(remaining / (4 * worker_count), 1, MAX_BATCH);
+
+    std::int64_t first = next_round.fetch_add(batch, std::memory_order_relaxed);
+    if (first >= total_rounds) return false;
+    std::int64_t last = std::min(first + batch, total_rounds);
+
+    // Pushed in reverse, so the owner pops the lowest round first and thieves
+    // take the highest.
+    for (std::int64_t round = last - 1; round >= first; --round) {
+        worker.rounds.push(round);
+    }
+    return true;
+}
+
+std::int64_t GameScheduler::steal_round(int thief) {
+    while (true) {
+        bool contended = false;
+        for (int i = 1; i < worker_count; ++i) {
+            std::int64_t round = workers[(thief + i) % worker_count].rounds.steal();
+            if (round >= 0) return round;
+            if (round == WorkDeque::RETRY) contended = true;
+        }
+        // Rounds claimed by a worker but not yet pushed are played by that
+        // worker, so only a lost race is worth another pass.
+        if (!contended) return WorkDeque::EMPTY;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// --- Game Scheduler ---
+// Hands out the games of a match to the workers (threads or reactor slots).
+// Rounds are produced lazily from a shared counter, so a match of millions of
+// games takes no memory up front. Each worker buffers a few rounds in its own
+// lock-free deque and steals from the others once the counter runs dry. A
+// round is the game pair of one opening; both games go to the worker that
+// took the round, so they are played on the same warm engines.
+
+// Chase-Lev work-stealing deque of round numbers with a fixed capacity. Only
+// the owner pushes and pops (at the bottom); any thread may steal (at the top).
+class WorkDeque {
+   public:
+    static constexpr int CAPACITY = 32;  // Power of two
+    static constexpr std::int64_t EMPTY = -1;
+    static constexpr std::int64_t RETRY = -2;  // Lost a race with another thread
+
+    // Owner only; the caller guarantees there is room.
+    void push(std::int64_t round);
+    // Owner only. Returns EMPTY if there is nothing left.
+    std::int64_t pop();
+    // Any thread. Returns EMPTY or RETRY if nothing was taken.
+    std::int64_t steal();
+
+   private:
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    std::atomic<std::int64_t> items[CAPACITY]{};
+};
+
+class GameScheduler {
+   public:
+    // Prepares a match of `rounds` rounds (two games each) for workers
+    // numbered 0 to workers_in_match - 1. Games whose index is set in
+    // `finished` were played before the match was resumed and are skipped.
+    void start(std::int64_t rounds, int workers_in_match, std::vector<bool> finished = {});
+    // Ends the match early: no further games are handed out.
+    void stop();
+
+    // Takes the next game for `worker` as a 0-based game index; game 2r and
+    // 2r+1 are the two games of round r. Returns false when none are left.
+    bool next(int worker, std::int64_t &game);
+    // Takes back the second game of `worker`'s current round if it has not
+    // been handed out, for a worker that leaves the match. Owner only.
+    bool take_pending(int worker, std::int64_t &game);
+
+   private:
+    struct alignas(64) Worker {
+        WorkDeque rounds;
+        std::int64_t pending_game = -1;  // Second game of the current round; owner only
+    };
+
+    // Most rounds a worker takes from the counter at once.
+    static constexpr std::int64_t MAX_BATCH = 16;
+    static_assert(MAX_BATCH <= WorkDeque::CAPACITY);
+
+    std::unique_ptr<Worker[]> workers;
+    int worker_count = 0;
+    std::int64_t total_rounds = 0;
+    std::vector<bool> finished;  // Read-only during the match
+    alignas(64) std::atomic<std::int64_t> next_round{0};
+    std::atomic<bool> stopped{false};
+
+    // Moves a batch of fresh rounds into `worker`'s deque. Returns false if
+    // all rounds have been handed out.
+    bool refill(Worker &worker);
+    bool is_finished(std::int64_t game) const {
+        return game < static_cast<std::int64_t>(finished.size()) && finished[game];
+    }
+    // Takes a round from another worker's deque. Returns EMPTY if all are empty.
+    std::int64_t steal_round(int thief);
+};
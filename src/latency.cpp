@@ -0,0 +1,101 @@
+#include "latency.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include "protocol.hpp"
+
+LatencyStats g_latency_stats;
+
+namespace {
+
+std::string format_us(std::uint64_t us) {
+    if (us >= 1000000) return std::format("{:.2f}s", us / 1e6);
+    if (us >= 1000) return std::format("{:.2f}ms", us / 1e3);
+    return std::format("{}us", us);
+}
+
+}  // namespace
+
+// --- LatencyHistogram ---
+
+int LatencyHistogram::bucket_of(std::uint64_t us) {
+    if (us < 4) return static_cast<int>(us);
+    int exponent = 63 - __builtin_clzll(us);  // >= 2
+    int sub = static_cast<int>((us >> (exponent - 2)) & 3);
+    return std::min(4 * (exponent - 1) + sub, BUCKETS - 1);
+}
+
+std::uint64_t LatencyHistogram::bucket_floor(int bucket) {
+    if (bucket < 4) return static_cast<std::uint64_t>(bucket);
+    int exponent = bucket / 4 + 1;
+    return static_cast<std::uint64_t>(4 + bucket % 4) << (exponent - 2);
+}
+
+void LatencyHistogram::add(std::int64_t us) {
+    if (us < 0) return;
+    auto value = static_cast<std::uint64_t>(us);
+    counts[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t seen = max_us.load(std::memory_order_relaxed);
+    while (value > seen && !max_us.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto &count : counts) count.store(0, std::memory_order_relaxed);
+    total = 0;
+    sum_us = 0;
+    max_us = 0;
+}
+
+std::string LatencyHistogram::summary() const {
+    std::uint64_t n = total.load();
+    if (n == 0) return "no samples";
+
+    // Percentiles are reported as the upper edge of their bucket.
+    std::array<std::uint64_t, 3> percentiles{};
+    constexpr std::array<double, 3> RANKS = {0.50, 0.90, 0.99};
+    std::uint64_t seen = 0;
+    size_t next = 0;
+    for (int b = 0; b < BUCKETS && next < RANKS.size(); ++b) {
+        seen += counts[b].load(std::memory_order_relaxed);
+        while (next < RANKS.size() && seen >= RANKS[next] * n) {
+            std::uint64_t edge = b + 1 < BUCKETS ? bucket_floor(b + 1) - 1 : max_us.load();
+            percentiles[next++] = std::min(edge, max_us.load());
+        }
+    }
+
+    return std::format("n {} mean {} p50 {} p90 {} p99 {} max {}", n,
+                       format_us(sum_us.load() / n), format_us(percentiles[0]),
+                       format_us(percentiles[1]), format_us(percentiles[2]),
+                       format_us(max_us.load()));
+}
+
+// --- LatencyStats ---
+
+void LatencyStats::record(const MoveLatency &latency) {
+    write.add(latency.write_us);
+    first_output.add(latency.first_output_us);
+    bestmove.add(latency.bestmove_us);
+    dispatch.add(latency.dispatch_us);
+    arena.add(latency.arena_us);
+}
+
+void LatencyStats::reset() {
+    write.reset();
+    first_output.reset();
+    bestmove.reset();
+    dispatch.reset();
+    arena.reset();
+}
+
+void LatencyStats::report() const {
+    send_info_string("Latency per move (engine think time vs arena overhead):");
+    send_info_string("  write commands : " + write.summary());
+    send_info_string("  first output   : " + first_output.summary());
+    send_info_string("  bestmove       : " + bestmove.summary());
+    send_info_string("  dispatch       : " + dispatch.summary());
+    send_info_string("  arena          : " + arena.summary());
+}
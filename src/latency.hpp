@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// --- Latency Accounting ---
+// Microsecond breakdown of where the wall-clock time of each move goes, to
+// tell the engine's thinking apart from the arena's own overhead.
+
+// Timings of one move in microseconds; -1 if the point was never reached
+// (e.g. no bestmove because the engine hung).
+struct MoveLatency {
+    std::int64_t write_us = -1;         // Writing the position and go commands
+    std::int64_t first_output_us = -1;  // From go until the first byte of output
+    std::int64_t bestmove_us = -1;      // From go until the bestmove line was read
+    std::int64_t dispatch_us = -1;      // From reading bestmove until the game handled it
+    std::int64_t arena_us = -1;         // Validation, move bookkeeping, FEN, adjudication
+};
+
+inline std::int64_t microseconds_between(std::chrono::steady_clock::time_point from,
+                                         std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+// Lock-free histogram of durations with four buckets per power of two, so
+// percentiles are accurate to within 25%.
+class LatencyHistogram {
+   private:
+    static constexpr int BUCKETS = 128;
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> counts{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sum_us{0};
+    std::atomic<std::uint64_t> max_us{0};
+
+    static int bucket_of(std::uint64_t us);
+    static std::uint64_t bucket_floor(int bucket);
+
+   public:
+    void add(std::int64_t us);
+    void reset();
+
+    // One-line summary: count, mean, p50/p90/p99 and max.
+    std::string summary() const;
+};
+
+class LatencyStats {
+   private:
+    LatencyHistogram write;
+    LatencyHistogram first_output;
+    LatencyHistogram bestmove;
+    LatencyHistogram dispatch;
+    LatencyHistogram arena;
+
+   public:
+    // Adds the timings of one move; timings that are -1 are skipped.
+    void record(const MoveLatency &latency);
+    void reset();
+
+    // Sends one info string per histogram.
+    void report() const;
+};
+
+// Collected over all games of the current match.
+extern LatencyStats g_latency_stats;
@@ -0,0 +1,164 @@
+#include "league.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <map>
+#include <numeric>
+
+#include "sprt.hpp"
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+    size_t begin = s.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) return {};
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+std::vector<Player> parse_players(std::string_view list) {
+    std::vector<Player> players;
+    while (!list.empty()) {
+        size_t end = list.find(';');
+        std::string_view entry = list.substr(0, end);
+        list.remove_prefix(end == std::string_view::npos ? list.size() : end + 1);
+
+        size_t bar = entry.find('|');
+        Player player;
+        player.path = trim(entry.substr(0, bar));
+        if (bar != std::string_view::npos) player.options = trim(entry.substr(bar + 1));
+        if (!player.path.empty()) players.push_back(std::move(player));
+    }
+    return players;
+}
+
+void name_players(std::vector<Player> &players) {
+    std::map<std::string, int> uses;
+    for (Player &player : players) {
+        size_t slash = player.path.find_last_of("/\\");
+        player.name = slash == std::string::npos ? player.path : player.path.substr(slash + 1);
+        uses[player.name]++;
+    }
+    std::map<std::string, int> numbered;
+    for (Player &player : players) {
+        if (uses[player.name] > 1) {
+            player.name += std::format("#{}", ++numbered[player.name]);
+        }
+    }
+}
+
+std::vector<Pairing> make_pairings(TournamentMode mode, int player_count) {
+    std::vector<Pairing> pairings;
+    if (player_count < 2) return pairings;
+    if (mode == TournamentMode::MATCH) return {{0, 1}};
+    if (mode == TournamentMode::GAUNTLET) {
+        for (int opponent = 1; opponent < player_count; ++opponent) {
+            pairings.push_back({0, opponent});
+        }
+        return pairings;
+    }
+
+    // Round-robin: take the first pairing left that shares a player with the
+    // last one taken, so a worker has to start only one new engine.
+    std::vector<Pairing> left;
+    for (int a = 0; a < player_count; ++a) {
+        for (int b = a + 1; b < player_count; ++b) left.push_back({a, b});
+    }
+    while (!left.empty()) {
+        auto next = left.begin();
+        if (!pairings.empty()) {
+            const Pairing &last = pairings.back();
+            auto shares = std::find_if(left.begin(), left.end(), [&](const Pairing &p) {
+                return p.first == last.first || p.first == last.second ||
+                       p.second == last.first || p.second == last.second;
+            });
+            if (shares != left.end()) next = shares;
+        }
+        pairings.push_back(*next);
+        left.erase(next);
+    }
+    return pairings;
+}
+
+void Standings::reset(const std::vector<Player> &players, const std::vector<Pairing> &pairings_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    names.clear();
+    for (const Player &player : players) names.push_back(player.name);
+    pairings = pairings_;
+    pairing_scores.assign(pairings.size(), Score{});
+    player_scores.assign(players.size(), Score{});
+}
+
+int Standings::record(int pairing, double first_points) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Score &pair = pairing_scores[pairing];
+    Score &first = player_scores[pairings[pairing].first];
+    Score &second = player_scores[pairings[pairing].second];
+    if (first_points > 0.75) {
+        pair.wins++;
+        first.wins++;
+        second.losses++;
+    } else if (first_points < 0.25) {
+        pair.losses++;
+        first.losses++;
+        second.wins++;
+    } else {
+        pair.draws++;
+        first.draws++;
+        second.draws++;
+    }
+    return pair.wins + pair.losses + pair.draws;
+}
+
+std::string Standings::describe(const Score &score) {
+    int games = score.wins + score.losses + score.draws;
+    std::string counts = std::format("+{} -{} ={}", score.wins, score.losses, score.draws);
+    if (games == 0) return counts;
+
+    // Elo of the mean score, with a 95% interval from the variance of the
+    // per-game scores.
+    double mean = (score.wins + 0.5 * score.draws) / games;
+    double variance = (score.wins * (1 - mean) * (1 - mean) +
+                       score.draws * (0.5 - mean) * (0.5 - mean) + score.losses * mean * mean) /
+                      games;
+    double margin = 1.959964 * std::sqrt(variance / games);
+    double elo = score_to_elo(mean);
+    double error = (score_to_elo(mean + margin) - score_to_elo(mean - margin)) / 2;
+    return std::format("{} ({:.1f}%), Elo {:+.1f} +/- {:.1f}", counts, mean * 100, elo, error);
+}
+
+std::string Standings::pairing_summary(int pairing) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Pairing &p = pairings[pairing];
+    return std::format("{} vs {}: {}", names[p.first], names[p.second],
+                       describe(pairing_scores[pairing]));
+}
+
+std::vector<std::string> Standings::table() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto points = [this](int player) {
+        const Score &s = player_scores[player];
+        int games = s.wins + s.losses + s.draws;
+        return games ? (s.wins + 0.5 * s.draws) / games : 0.0;
+    };
+    std::vector<int> order(names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return points(a) > points(b); });
+
+    std::vector<std::string> lines;
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        int player = order[rank];
+        lines.push_back(std::format("{:>2}. {:<20} {}", rank + 1, names[player],
+                                    describe(player_scores[player])));
+    }
+    for (size_t i = 0; i < pairings.size(); ++i) {
+        const Pairing &p = pairings[i];
+        lines.push_back(std::format("    {} vs {}: {}", names[p.first], names[p.second],
+                                    describe(pairing_scores[i])));
+    }
+    return lines;
+}
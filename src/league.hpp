@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// --- Multi-Engine Tournaments ---
+// Besides the match between Engine1 and Engine2, the arena can play a
+// round-robin between any number of engines or a gauntlet of Engine1
+// against each of the others, all in one process. Every pairing plays
+// TotalRounds rounds. The rounds of a pairing are handed out consecutively
+// and consecutive pairings share an engine, so workers keep playing with the
+// engine processes they already have running.
+
+enum class TournamentMode { MATCH, ROUND_ROBIN, GAUNTLET };
+
+struct Player {
+    std::string path;
+    std::string options;  // UCI options, as in Engine1Options
+    std::string name;     // Distinct display name
+};
+
+// Two players meeting in a tournament. The first plays Red in the first game
+// of every round.
+struct Pairing {
+    int first;
+    int second;
+};
+
+// Parses the ExtraEngines option: entries separated by ';', each a path
+// optionally followed by '|' and the engine's options.
+std::vector<Player> parse_players(std::string_view list);
+
+// Names every player after the file name of its path, numbered where the
+// same file name occurs more than once.
+void name_players(std::vector<Player> &players);
+
+// The pairings of a tournament of `player_count` players, ordered so that
+// each pairing shares a player with the one before wherever possible. MATCH
+// pairs the first two players only.
+std::vector<Pairing> make_pairings(TournamentMode mode, int player_count);
+
+// Win/loss/draw counts and Elo, per pairing and per player. Thread-safe.
+class Standings {
+   public:
+    void reset(const std::vector<Player> &players, const std::vector<Pairing> &pairings);
+
+    // Adds a game of `pairing` in which its first player scored `first_points`
+    // (1, 0.5 or 0). Returns the number of games of the pairing so far.
+    int record(int pairing, double first_points);
+
+    // "A vs B: +W -L =D (S%), Elo E +/- M", from A's point of view.
+    std::string pairing_summary(int pairing) const;
+
+    // Lines of a table of all players, best score first, with their Elo over
+    // all their games.
+    std::vector<std::string> table() const;
+
+   private:
+    struct Score {
+        int wins = 0;
+        int losses = 0;
+        int draws = 0;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<Pairing> pairings;
+    std::vector<Score> pairing_scores;  // From the first player's point of view
+    std::vector<Score> player_scores;
+
+    static std::string describe(const Score &score);
+};
@@ -1,7 +1,16 @@
 #include "logger.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
 // Initialize static member
-bool LoggerConfig::enabled = true;
+std::atomic<bool> LoggerConfig::enabled = true;
 
 void LoggerConfig::set_enabled(bool enable) {
     enabled = enable;
@@ -11,35 +20,286 @@ bool LoggerConfig::is_enabled() {
     return enabled;
 }
 
-Logger::Logger(const std::string &name, int job_id) : engine_name(name) {
+// --- Background Log Writer ---
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Buffered output of one file that triggers a write, and the longest time
+// output stays buffered.
+constexpr size_t FLUSH_BYTES = 64 * 1024;
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(200);
+// How long the writer sleeps when there is nothing to do.
+constexpr auto IDLE_SLEEP = std::chrono::milliseconds(2);
+// Number of records the queue holds; must be a power of two.
+constexpr size_t QUEUE_CAPACITY = 8192;
+
+std::atomic<std::uint64_t> g_dropped_lines(0);
+
+enum class RecordKind { OPEN, CLOSE, FLUSH, TO_ENGINE, FROM_ENGINE };
+
+struct Record {
+    RecordKind kind = RecordKind::FLUSH;
+    int file_id = -1;
+    std::uint32_t dropped_before = 0;  // Lines of this file dropped just before this one
+    Clock::time_point time;
+    // Line text, or the file name for OPEN. Records are reused, so after a
+    // warm-up these strings no longer allocate.
+    std::string text;
+    std::string engine_name;  // OPEN only
+};
+
+// Bounded lock-free multi-producer single-consumer queue. Every cell carries
+// a sequence number that tells producers and the consumer whose turn it is,
+// so producers only contend on one atomic increment.
+class RecordQueue {
+   private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) size_t dequeue_pos = 0;  // Consumer only
+
+   public:
+    RecordQueue() : cells(new Cell[QUEUE_CAPACITY]) {
+        for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Claims a free cell, lets `fill` write the record and publishes it.
+    // Returns false if the queue is full.
+    template <typename Fill>
+    bool try_push(Fill &&fill) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = cells[pos & (QUEUE_CAPACITY - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.record);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // The consumer has not freed this cell yet
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Hands the oldest record to `consume`. Returns false if the queue is empty.
+    template <typename Consume>
+    bool try_pop(Consume &&consume) {
+        Cell &cell = cells[dequeue_pos & (QUEUE_CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+            return false;
+        }
+        consume(cell.record);
+        cell.sequence.store(dequeue_pos + QUEUE_CAPACITY, std::memory_order_release);
+        ++dequeue_pos;
+        return true;
+    }
+};
+
+class LogWriter {
+   private:
+    struct OpenFile {
+        std::ofstream stream;
+        std::string engine_name;
+        std::string pending;  // Formatted lines not written yet
+    };
+
+    RecordQueue queue;
+    std::atomic<int> next_file_id{0};
+    std::atomic<bool> stopping{false};
+    Clock::time_point epoch = Clock::now();
+    std::unordered_map<int, OpenFile> files;  // Writer thread only
+    std::thread thread;                       // Started last
+
+    void run() {
+        auto last_flush = Clock::now();
+        while (true) {
+            // Read before draining, so that records queued before shutdown
+            // are still written.
+            bool done = stopping.load(std::memory_order_acquire);
+            bool idle = true;
+            while (queue.try_pop([this](Record &record) { handle(record); })) {
+                idle = false;
+            }
+
+            auto now = Clock::now();
+            if (done || now - last_flush >= FLUSH_INTERVAL) {
+                for (auto &[id, file] : files) write_out(file);
+                last_flush = now;
+            }
+            if (done) break;
+            if (idle) std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+        files.clear();
+    }
+
+    void handle(Record &record) {
+        if (record.kind == RecordKind::OPEN) {
+            OpenFile &file = files[record.file_id];
+            file.engine_name = record.engine_name;
+            file.stream.open(record.text, std::ios::app);
+            file.pending += std::format("[{}] Engine debug log started\n", file.engine_name);
+            return;
+        }
+
+        auto it = files.find(record.file_id);
+        if (it == files.end()) return;
+        OpenFile &file = it->second;
+
+        double seconds = std::chrono::duration<double>(record.time - epoch).count();
+        if (record.dropped_before > 0) {
+            file.pending += std::format("[{:12.6f}] ({} lines dropped, logger queue full)\n",
+                                        seconds, record.dropped_before);
+        }
+
+        switch (record.kind) {
+            case RecordKind::CLOSE:
+                write_out(file);
+                files.erase(it);
+                return;
+            case RecordKind::FLUSH:
+                write_out(file);
+                return;
+            default:
+                break;
+        }
+
+        file.pending += std::format("[{:12.6f}] [{} {}]: {}\n", seconds,
+                                    record.kind == RecordKind::TO_ENGINE ? "TO" : "FROM",
+                                    file.engine_name, record.text);
+        if (file.pending.size() >= FLUSH_BYTES) write_out(file);
+    }
+
+    static void write_out(OpenFile &file) {
+        if (file.pending.empty()) return;
+        if (file.stream.is_open()) {
+            file.stream.write(file.pending.data(),
+                              static_cast<std::streamsize>(file.pending.size()));
+            file.stream.flush();
+        }
+        file.pending.clear();
+    }
+
+   public:
+    LogWriter() : thread([this] { run(); }) {}
+
+    ~LogWriter() {
+        stopping.store(true, std::memory_order_release);
+        thread.join();
+    }
+
+    static LogWriter &instance() {
+        static LogWriter writer;
+        return writer;
+    }
+
+    int new_file_id() { return next_file_id++; }
+
+    // Queues a line. Returns false if the queue is full and the line was dropped.
+    bool push_line(int file_id, bool to_engine, std::uint32_t dropped_before,
+                   std::string_view text) {
+        auto time = Clock::now();
+        return queue.try_push([&](Record &record) {
+            record.kind = to_engine ? RecordKind::TO_ENGINE : RecordKind::FROM_ENGINE;
+            record.file_id = file_id;
+            record.dropped_before = dropped_before;
+            record.time = time;
+            record.text.assign(text);
+        });
+    }
+
+    // Queues a control record. These are never dropped: if the queue is full
+    // the caller waits for the writer to make room.
+    void push_control(RecordKind kind, int file_id, std::uint32_t dropped_before = 0,
+                      std::string_view file_name = {}, std::string_view engine_name = {}) {
+        auto time = Clock::now();
+        auto fill = [&](Record &record) {
+            record.kind = kind;
+            record.file_id = file_id;
+            record.dropped_before = dropped_before;
+            record.time = time;
+            record.text.assign(file_name);
+            record.engine_name.assign(engine_name);
+        };
+        while (!queue.try_push(fill)) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+}  // namespace
+
+// --- Logger ---
+
+Logger::Logger(const std::string &name, int job_id) {
+    open(name, job_id);
+}
+
+void Logger::open(const std::string &name, int job_id) {
+    if (file_id >= 0) {
+        LogWriter::instance().push_control(RecordKind::CLOSE, file_id, dropped);
+        file_id = -1;
+    }
+    engine_name = name;
+    dropped = 0;
+
     // Only create log file if logging is enabled
     if (!LoggerConfig::is_enabled()) {
         return;
     }
 
+    LogWriter &writer = LogWriter::instance();
+    file_id = writer.new_file_id();
     std::string filename = std::format("engine_debug_{}_job{}.log", name, job_id);
-    log_file.open(filename, std::ios::app);
-    if (log_file.is_open()) {
-        log_file << std::format("[{}] Engine debug log started\n", engine_name) << std::flush;
-    }
+    writer.push_control(RecordKind::OPEN, file_id, 0, filename, engine_name);
 }
 
 Logger::~Logger() {
-    if (log_file.is_open()) {
-        log_file.close();
+    if (file_id >= 0) {
+        LogWriter::instance().push_control(RecordKind::CLOSE, file_id, dropped);
     }
 }
 
-void Logger::log_to_engine(const std::string &message) {
-    // Only log if logging is enabled and file is open
-    if (LoggerConfig::is_enabled() && log_file.is_open()) {
-        log_file << std::format("[TO {}]: {}\n", engine_name, message) << std::flush;
+void Logger::log(bool to_engine, const std::string &message) {
+    // Only log if logging is enabled and a file is open
+    if (!LoggerConfig::is_enabled() || file_id < 0) {
+        return;
+    }
+    if (LogWriter::instance().push_line(file_id, to_engine, dropped, message)) {
+        dropped = 0;
+    } else {
+        dropped++;
+        g_dropped_lines++;
     }
 }
 
+void Logger::log_to_engine(const std::string &message) {
+    log(true, message);
+}
+
 void Logger::log_from_engine(const std::string &message) {
-    // Only log if logging is enabled and file is open
-    if (LoggerConfig::is_enabled() && log_file.is_open()) {
-        log_file << std::format("[FROM {}]: {}\n", engine_name, message) << std::flush;
+    log(false, message);
+}
+
+void Logger::flush() {
+    if (file_id >= 0) {
+        LogWriter::instance().push_control(RecordKind::FLUSH, file_id, dropped);
+        dropped = 0;
     }
-}
\ No newline at end of file
+}
+
+std::uint64_t Logger::dropped_lines() {
+    return g_dropped_lines;
+}
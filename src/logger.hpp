@@ -1,7 +1,7 @@
 #pragma once
 
-#include <format>
-#include <fstream>
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 // --- Global Configuration ---
@@ -12,7 +12,7 @@
 //   bool enabled = LoggerConfig::is_enabled(); // Check current state
 class LoggerConfig {
    private:
-    static bool enabled;
+    static std::atomic<bool> enabled;
 
    public:
     // Enable or disable global logging
@@ -28,11 +28,21 @@ class LoggerConfig {
 // Logger class for engine communication debugging.
 // Respects the global LoggerConfig setting - if logging is disabled,
 // no files will be created and no logging will occur.
+//
+// Logging never blocks the caller on file I/O: lines are timestamped with a
+// monotonic clock and handed to a background writer thread through a
+// lock-free queue. The writer formats and batches them, and writes a file
+// when enough output has accumulated, every 200 ms, and when flush() is
+// called at the end of a game. If the queue is full the line is dropped and
+// counted; the log file then notes how many lines are missing.
 
 class Logger {
    private:
-    std::ofstream log_file;
+    int file_id = -1;  // Writer-side file, or -1 if not logging
     std::string engine_name;
+    std::uint32_t dropped = 0;  // Lines dropped since the last one queued
+
+    void log(bool to_engine, const std::string &message);
 
    public:
     // Create a logger for the specified engine name
@@ -40,6 +50,13 @@ class Logger {
     Logger(const std::string &name, int job_id = 0);
     ~Logger();
 
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    // Close the current log file (if any) and start logging to the file for
+    // the given engine name and job. Used when an engine is reused for a new game.
+    void open(const std::string &name, int job_id);
+
     // Log a message sent to the engine
     // Only logs if global logging is enabled
     void log_to_engine(const std::string &message);
@@ -47,4 +64,10 @@ class Logger {
     // Log a message received from the engine
     // Only logs if global logging is enabled
     void log_from_engine(const std::string &message);
-};
\ No newline at end of file
+
+    // Ask the writer to write out everything logged so far, e.g. at game end.
+    void flush();
+
+    // Total number of lines dropped because the writer fell behind.
+    static std::uint64_t dropped_lines();
+};
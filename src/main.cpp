@@ -1,6 +1,10 @@
 #include <algorithm>
 #include <atomic>
-#include <deque>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cstdint>
 #include <format>
 #include <fstream>  // For file input
 #include <iostream>
@@ -9,42 +13,69 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <filesystem>
 #include <ctime>
 #include <memory>
 
+#include "cpu_affinity.hpp"
+#include "distributed.hpp"
+#include "engine_pool.hpp"
 #include "game.hpp"
+#include "game_archive.hpp"
+#include "game_scheduler.hpp"
+#include "latency.hpp"
+#include "league.hpp"
 #include "logger.hpp"
+#include "match_journal.hpp"
+#include "opening_book.hpp"
 #include "protocol.hpp"
+#include "random.hpp"
+#include "reactor.hpp"
+#include "sprt.hpp"
 #include "time_manager.hpp"
+#include "tournament.hpp"
 #include "types.hpp"
 
 // --- Global State for Tournament Configuration ---
 std::string g_engine1_path, g_engine2_path;
 std::string g_engine1_options, g_engine2_options;
+TournamentMode g_tournament_mode = TournamentMode::MATCH;
+std::string g_extra_engines;  // Further players of round-robins and gauntlets
 std::string g_book_file_path;  // Path to the opening book file
 bool g_save_notation = false;
 std::string g_save_notation_dir = "notations";
+NotationFormat g_notation_format = NotationFormat::ARCHIVE;
+bool g_notation_compression = true;
 int g_rounds = 10;
 int g_concurrency = 2;
+std::string g_scheduler = "Threads";  // "Threads" or "Reactor"
+int g_reactor_threads = 1;
+bool g_cpu_affinity = false;
+int g_cores_per_game = 1;
 TimeControl g_tc = {1000, 1000, 100, 100};  // Default 1s + 0.1s
 int g_timeout_buffer_ms = 5000;             // Default 5s
+std::uint64_t g_seed = 0;  // 0 picks a random seed for each match
+bool g_paired_flips = false;
+bool g_sprt_enabled = false;
+SprtConfig g_sprt_config;
+std::string g_checkpoint_dir = "checkpoints";  // Empty disables the match journal
+std::string g_resume_from;                     // Journal of the match to continue
+std::string g_listen_address;  // Set for a coordinator of worker nodes
+int g_lease_ms = 10000;
+// Options that affect how games are played, passed on to worker nodes
+std::vector<std::pair<std::string, std::string>> g_node_options;
 
 // --- Shared Tournament Resources ---
-struct GameTask {
-    int game_id;
-    std::string red_engine_path;
-    std::string black_engine_path;
-    std::string red_engine_options;
-    std::string black_engine_options;
-    std::string start_fen;
-    bool red_is_engine1;
-};
-
-std::deque<GameTask> g_game_queue;
-std::mutex g_queue_mutex;
-std::vector<std::string> g_fen_book;  // Vector to store FENs from the book
+GameScheduler g_game_scheduler;
+OpeningBook g_fen_book;       // Mapped opening book
+std::uint64_t g_match_seed = 0;  // Seed of the match in progress
+std::vector<Player> g_players;   // Engine1, Engine2, then ExtraEngines
+std::vector<Pairing> g_pairings;
+std::int64_t g_total_games = 0;
+Standings g_standings;
 std::atomic<double> g_score_engine1(0.0);
 std::atomic<double> g_score_engine2(0.0);
 std::atomic<int> g_draws(0);
@@ -52,41 +83,26 @@ std::atomic<int> g_wins_engine1(0);
 std::atomic<int> g_losses_engine1(0);
 std::atomic<int> g_games_completed(0);  // To track total games finished across all workers
 std::atomic<bool> g_stop_match(false);
+// SPRT state, and the first game's engine1 points of rounds still in play
+Sprt g_sprt;
+SprtResult g_sprt_result = SprtResult::CONTINUE;
+std::unordered_map<int, double> g_sprt_open_pairs;
+std::mutex g_sprt_mutex;
 std::thread g_tournament_thread;
 
 // Global engine management
 std::vector<Engine *> g_active_engines;
 std::mutex g_engines_mutex;
-// Thread-safe file writing mutex
-std::mutex g_file_write_mutex;
+// Core sets per game slot; empty when CpuAffinity is off
+std::vector<SlotAffinity> g_slot_affinity;
+// Writes the notation of finished games in the background
+GameArchiveWriter g_game_archive;
+// Checkpoint of the finished games, for resuming the match
+MatchJournal g_match_journal;
+// Connection to the coordinator while this process is a worker node
+CoordinatorLink *g_coordinator_link = nullptr;
 
 // --- Helpers for Notation Saving ---
-static std::string json_escape(const std::string &s) {
-    std::string out;
-    out.reserve(s.size() + 8);
-    for (char c : s) {
-        switch (c) {
-            case '\\': out += "\\\\"; break;
-            case '"': out += "\\\""; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default:
-                if (static_cast<unsigned char>(c) < 0x20) {
-                    out += "\\u";
-                    const char *hex = "0123456789abcdef";
-                    out += hex[(c >> 12) & 0xF];
-                    out += hex[(c >> 8) & 0xF];
-                    out += hex[(c >> 4) & 0xF];
-                    out += hex[c & 0xF];
-                } else {
-                    out += c;
-                }
-        }
-    }
-    return out;
-}
-
 static std::string current_date_iso() {
     std::time_t t = std::time(nullptr);
     std::tm tm;
@@ -121,32 +137,97 @@ void stop_all_engines() {
     g_active_engines.clear();
 }
 
-Color play_game(const GameTask &task, bool is_primary) {
-    Engine red_engine("Red", task.game_id);
-    Engine black_engine("Black", task.game_id);
+void save_game_notation(const GameTask &task, const Game &game, Color result) {
+    // Games cut short by a stop command are played again when the match is resumed.
+    if (!g_save_notation || g_stop_match) return;
+
+    GameRecord record;
+    record.game_id = task.game_id;
+    record.seed = g_match_seed;
+    record.date = current_date_iso();
+    record.red_name = basename_from_path(task.red_engine_path);
+    record.black_name = basename_from_path(task.black_engine_path);
+    record.result = result_to_string(result);
+    record.initial_fen = game.get_initial_fen();
+    record.current_fen = game.generate_fen();
+    record.moves = game.get_notation_moves();
+    record.stats = {game.engine_stats(Color::RED), game.engine_stats(Color::BLACK)};
+    if (g_coordinator_link) {
+        g_coordinator_link->report_record(record);
+    } else {
+        save_game_record(std::move(record));
+    }
+}
+
+void save_game_record(GameRecord record) {
+    if (!g_save_notation) return;
+    g_game_archive.submit(std::move(record));
+}
 
-    // Add engines to global list for management
-    {
-        std::lock_guard<std::mutex> lock(g_engines_mutex);
-        g_active_engines.push_back(&red_engine);
-        g_active_engines.push_back(&black_engine);
+void report_game_stats(const GameTask &task, const Game &game) {
+    for (Color side : {Color::RED, Color::BLACK}) {
+        EngineGameStats stats = game.engine_stats(side);
+        if (stats.moves == 0) continue;
+
+        std::string profile;
+        for (int b = 0; b < EngineGameStats::PROFILE_BUCKETS; ++b) {
+            if (stats.profile_moves[b] == 0) continue;
+            int first = b * EngineGameStats::PROFILE_BUCKET_MOVES + 1;
+            std::string range = b + 1 < EngineGameStats::PROFILE_BUCKETS
+                                    ? std::format("{}-{}", first,
+                                                  first + EngineGameStats::PROFILE_BUCKET_MOVES - 1)
+                                    : std::format("{}+", first);
+            profile += std::format(" {}:{:.0f}", range, stats.profile_avg_time_ms[b]);
+        }
+
+        const std::string &path =
+            side == Color::RED ? task.red_engine_path : task.black_engine_path;
+        send_info_string(std::format(
+            "[Game {}] Stats {} ({}): moves {} avg depth {:.1f} seldepth {:.1f} nps {:.0f} "
+            "nodes {} time {} ms; ms/move by move number{}",
+            task.game_id, side == Color::RED ? "Red" : "Black", basename_from_path(path),
+            stats.moves, stats.avg_depth, stats.avg_seldepth, stats.avg_nps, stats.total_nodes,
+            stats.total_time_ms, profile));
     }
+}
 
-    if (!red_engine.start(task.red_engine_path)) {
+CpuSet engine_cpus(const GameTask &task, int slot, Color side) {
+    if (g_slot_affinity.empty()) return {};
+    const SlotAffinity &affinity = g_slot_affinity[slot % g_slot_affinity.size()];
+    bool is_engine1 = (side == Color::RED) == task.red_is_first;
+    return is_engine1 ? affinity.engine1 : affinity.engine2;
+}
+
+std::unique_ptr<Game> create_game(const GameTask &task, Engine &red, Engine &black) {
+    std::unique_ptr<Game> game =
+        task.start_record
+            ? std::make_unique<Game>(red, black, *task.start_record, g_tc, g_timeout_buffer_ms)
+            : std::make_unique<Game>(red, black, task.start_fen, g_tc, g_timeout_buffer_ms);
+    game->set_flip_key(task.flip_key);
+    return game;
+}
+
+Color play_game(const GameTask &task, int worker_id, bool is_primary, EnginePool &pool) {
+    // Engines are borrowed from the worker's pool and stay alive after the game.
+    Engine *red_engine =
+        pool.acquire(task.red_engine_path, task.red_engine_options,
+                     engine_cpus(task, worker_id, Color::RED), "Red", task.game_id);
+    if (!red_engine) {
         send_info_string(std::format("[Game {}] Failed to start Red engine ({}). Black wins.",
                                      task.game_id, task.red_engine_path));
+        pool.release_all();
         return Color::BLACK;
     }
-    if (!black_engine.start(task.black_engine_path)) {
+    Engine *black_engine =
+        pool.acquire(task.black_engine_path, task.black_engine_options,
+                     engine_cpus(task, worker_id, Color::BLACK), "Black", task.game_id);
+    if (!black_engine) {
         send_info_string(std::format("[Game {}] Failed to start Black engine ({}). Red wins.",
                                      task.game_id, task.black_engine_path));
-        red_engine.stop();
+        pool.release_all();
         return Color::RED;
     }
 
-    red_engine.apply_uci_options(task.red_engine_options);
-    black_engine.apply_uci_options(task.black_engine_options);
-
     Color result = Color::NONE;
     std::unique_ptr<Game> game_ptr;
     try {
@@ -154,12 +235,10 @@ Color play_game(const GameTask &task, bool is_primary) {
             return Color::NONE;
         }
 
-        // Use the FEN provided in the game task.
-        const std::string &initial_fen = task.start_fen;
+        game_ptr = create_game(task, *red_engine, *black_engine);
         if (is_primary) {
-            send_to_gui(std::format("info fen {}", initial_fen));
+            send_to_gui(std::format("info fen {}", game_ptr->get_initial_fen()));
         }
-        game_ptr = std::make_unique<Game>(red_engine, black_engine, initial_fen, g_tc, g_timeout_buffer_ms);
         // Pass the primary flag to the game
         result = game_ptr->run(is_primary);
     } catch (const std::exception &e) {
@@ -168,117 +247,142 @@ Color play_game(const GameTask &task, bool is_primary) {
         result = Color::NONE;
     }
 
-    red_engine.stop();
-    black_engine.stop();
+    pool.release_all();
 
-    // Save notation if enabled (all workers can save)
-    if (g_save_notation && game_ptr) {
-        try {
-            std::lock_guard<std::mutex> file_lock(g_file_write_mutex);
-            std::filesystem::create_directories(g_save_notation_dir);
-            std::string filename = std::format("{}/game_{}.json", g_save_notation_dir, task.game_id);
-            std::ofstream ofs(filename, std::ios::out | std::ios::trunc);
-            if (!ofs) {
-                send_info_string(std::format("[Game {}] Failed to write notation file {}", task.game_id, filename));
-            } else {
-                // Metadata
-                std::string red_name = basename_from_path(task.red_engine_path);
-                std::string black_name = basename_from_path(task.black_engine_path);
-                std::string date_str = current_date_iso();
-                std::string current_fen = game_ptr->generate_fen();
-
-                ofs << "{\n";
-                ofs << "  \"metadata\": {\n";
-                ofs << "    \"event\": \"Jieqi Game\",\n";
-                ofs << "    \"site\": \"jieqibox\",\n";
-                ofs << "    \"date\": \"" << json_escape(date_str) << "\",\n";
-                ofs << "    \"round\": \"" << task.game_id << "\",\n";
-                ofs << "    \"white\": \"" << json_escape(red_name) << "\",\n";
-                ofs << "    \"black\": \"" << json_escape(black_name) << "\",\n";
-                ofs << "    \"result\": \"" << result_to_string(result) << "\",\n";
-                ofs << "    \"initialFen\": \"" << json_escape(task.start_fen) << "\",\n";
-                ofs << "    \"flipMode\": \"random\",\n";
-                ofs << "    \"currentFen\": \"" << json_escape(current_fen) << "\"\n";
-                ofs << "  },\n";
-
-                // Moves
-                ofs << "  \"moves\": [\n";
-                const auto &moves = game_ptr->get_notation_moves();
-                for (size_t i = 0; i < moves.size(); ++i) {
-                    const auto &m = moves[i];
-                    ofs << "    {\n";
-                    ofs << "      \"type\": \"" << json_escape(m.type) << "\",\n";
-                    ofs << "      \"data\": \"" << json_escape(m.data) << "\",\n";
-                    ofs << "      \"fen\": \"" << json_escape(m.fen) << "\"";
-                    // Optional engine fields
-                    ofs << ",\n      \"engineScore\": " << (m.hasEngineScore ? m.engineScore : 0);
-                    ofs << ",\n      \"engineTime\": " << m.engineTime << "\n";
-                    ofs << "    }";
-                    if (i + 1 < moves.size()) ofs << ",";
-                    ofs << "\n";
-                }
-                ofs << "  ]\n";
-                ofs << "}\n";
-                ofs.close();
-                send_info_string(std::format("[Game {}] Notation saved to {} (worker: {})", task.game_id, filename, is_primary ? "primary" : "secondary"));
-            }
-        } catch (const std::exception &e) {
-            send_info_string(std::format("[Game {}] Error saving notation: {}", task.game_id, e.what()));
-        }
-    }
-
-    // Remove engines from global list
-    {
-        std::lock_guard<std::mutex> lock(g_engines_mutex);
-        g_active_engines.erase(
-            std::remove(g_active_engines.begin(), g_active_engines.end(), &red_engine),
-            g_active_engines.end());
-        g_active_engines.erase(
-            std::remove(g_active_engines.begin(), g_active_engines.end(), &black_engine),
-            g_active_engines.end());
+    if (game_ptr) {
+        report_game_stats(task, *game_ptr);
+        save_game_notation(task, *game_ptr, result);
     }
 
     return result;
 }
 
-void worker(int worker_id) {
-    bool is_primary_worker = (worker_id == 0);
-
-    while (true) {
-        if (g_stop_match) {
-            // No need for info string here, will be spammy if many workers exist
-            return;
+// Builds the task of the 0-based game index `game`.
+static void make_game_task(std::int64_t game, GameTask &task) {
+    // Each pairing plays g_rounds consecutive rounds. Both games of a round
+    // start from the same opening, sampled from the book in seeded order, and
+    // every pairing plays the same openings.
+    std::int64_t round = game / 2;
+    int pairing = static_cast<int>(round / g_rounds);
+    std::int64_t opening_round = round % g_rounds;
+    std::string start_pos_fen;
+    std::optional<BookRecord> start_record;
+    if (!g_fen_book.empty() && g_fen_book.is_binary()) {
+        size_t index = g_fen_book.opening_index(opening_round, g_match_seed);
+        start_record = g_fen_book.record(index);
+        if (!book_record_in_range(*start_record)) {
+            // A damaged record is replaced by the standard start position.
+            send_info_string(std::format(
+                "Warning: book record {} is damaged; game {} starts from the initial position.",
+                index, game + 1));
+            start_record.reset();
         }
+    } else if (!g_fen_book.empty()) {
+        start_pos_fen = g_fen_book.position(g_fen_book.opening_index(opening_round, g_match_seed));
+    }
+    if (!start_record && start_pos_fen.empty()) {
+        start_pos_fen = "xxxxkxxxx/9/1x5x1/x1x1x1x1x/9/9/X1X1X1X1X/1X5X1/9/XXXXKXXXX w "
+                        "R2r2N2n2B2b2A2a2C2c2P5p5 0 1";
+    }
+    const Player &first = g_players[g_pairings[pairing].first];
+    const Player &second = g_players[g_pairings[pairing].second];
+    if (game % 2 == 0) {
+        task = {static_cast<int>(game + 1), first.path, second.path, first.options,
+                second.options, start_pos_fen, true};
+    } else {
+        task = {static_cast<int>(game + 1), second.path, first.path, second.options,
+                first.options, start_pos_fen, false};
+    }
+    task.start_record = start_record;
+    task.pairing = pairing;
+    // With PairedFlips both games of a round share the key, so each color
+    // gets the same flips in both, whichever engine plays it.
+    task.flip_key =
+        derive_key(g_match_seed, RandomStream::FLIPS, g_paired_flips ? opening_round : game);
+}
 
-        GameTask task;
-        int total_games;
-        {
-            std::lock_guard<std::mutex> lock(g_queue_mutex);
-            if (g_game_queue.empty()) {
-                return;
-            }
-            task = g_game_queue.front();
-            g_game_queue.pop_front();
-            total_games = g_rounds * 2;  // Get total games count for reporting
-        }
+bool next_game_task(int worker_id, GameTask &task) {
+    // Worker nodes play what the coordinator sends.
+    if (g_coordinator_link) {
+        return g_coordinator_link->next_task(worker_id, task);
+    }
+    std::int64_t game;
+    if (!g_game_scheduler.next(worker_id, game)) {
+        return false;
+    }
+    make_game_task(game, task);
+    return true;
+}
 
-        send_info_string(std::format("Starting Game {} on worker {} (Primary: {})", task.game_id,
-                                     worker_id, is_primary_worker));
+bool take_unplayed_game(int worker_id, GameTask &task) {
+    std::int64_t game;
+    if (!g_game_scheduler.take_pending(worker_id, game)) {
+        return false;
+    }
+    make_game_task(game, task);
+    return true;
+}
 
-        // Extract engine names from paths for info engine command
-        if (is_primary_worker) {
-            std::string red_engine_name =
-                task.red_engine_path.substr(task.red_engine_path.find_last_of("/\\") + 1);
-            std::string black_engine_name =
-                task.black_engine_path.substr(task.black_engine_path.find_last_of("/\\") + 1);
-            send_engine_info(red_engine_name, black_engine_name);
-        }
+void announce_game(const GameTask &task, int worker_id, bool is_primary) {
+    send_info_string(std::format("Starting Game {} on worker {} (Primary: {})", task.game_id,
+                                 worker_id, is_primary));
+
+    // Extract engine names from paths for info engine command
+    if (is_primary) {
+        std::string red_engine_name =
+            task.red_engine_path.substr(task.red_engine_path.find_last_of("/\\") + 1);
+        std::string black_engine_name =
+            task.black_engine_path.substr(task.black_engine_path.find_last_of("/\\") + 1);
+        send_engine_info(red_engine_name, black_engine_name);
+    }
+}
 
-        // Pass the primary flag to play_game
-        Color result = play_game(task, is_primary_worker);
+// Scores the rounds of the match for the SPRT once both of their games are
+// done, and stops handing out games when a bound is crossed. Games replayed
+// from a journal are scored without `report`.
+void record_sprt_game(const GameTask &task, double engine1_points, bool report) {
+    std::lock_guard<std::mutex> lock(g_sprt_mutex);
+    int round = (task.game_id - 1) / 2;
+    auto [it, first_of_pair] = g_sprt_open_pairs.try_emplace(round, engine1_points);
+    if (first_of_pair) return;
+
+    g_sprt.add_pair(it->second + engine1_points);
+    g_sprt_open_pairs.erase(it);
+    if (report) send_info_string("SPRT " + g_sprt.summary());
+
+    if (g_sprt_result != SprtResult::CONTINUE) return;
+    g_sprt_result = g_sprt.status();
+    if (g_sprt_result != SprtResult::CONTINUE && report) {
+        send_info_string(std::format("SPRT: {} accepted after {} pairs. Finishing running games.",
+                                     g_sprt_result == SprtResult::ACCEPT_H1 ? "H1" : "H0",
+                                     g_sprt.pairs()));
+        g_game_scheduler.stop();
+    }
+}
 
-        bool e1_was_red = task.red_is_engine1;
+// Sends the standings of all players of a round-robin or gauntlet.
+void report_standings(const std::string &title) {
+    send_info_string(title);
+    for (const std::string &line : g_standings.table()) {
+        send_info_string(line);
+    }
+}
+
+// Adds a finished game to the scores, the standings and the SPRT. Returns
+// the number of finished games of its pairing.
+int score_game(const GameTask &task, Color result, bool report) {
+    double first_points = 0.5;
+    if (result != Color::NONE) first_points = (result == Color::RED) == task.red_is_first;
+
+    // Games cut short by a stop command say nothing about the engines.
+    if (g_sprt_enabled && g_pairings.size() == 1 && !g_stop_match) {
+        record_sprt_game(task, first_points, report);
+    }
 
+    // The W/L/D sent to the GUI is Engine1's. Engine1 is the first player of
+    // every pairing it plays in.
+    if (g_pairings[task.pairing].first == 0) {
+        bool e1_was_red = task.red_is_first;
         if (result == Color::RED) {
             if (e1_was_red) {
                 g_score_engine1 += 1.0;
@@ -301,19 +405,66 @@ void worker(int worker_id) {
             g_score_engine2 += 0.5;
             g_draws++;
         }
+    }
+    return g_standings.record(task.pairing, first_points);
+}
 
-        // Increment total games completed and send universal updates
-        int completed_count = ++g_games_completed;
+void record_game_result(const GameTask &task, Color result) {
+    // Worker nodes leave the scoring to the coordinator.
+    if (g_coordinator_link) {
+        g_coordinator_link->report_result(task.game_id, result);
+        return;
+    }
 
+    int pairing_games = score_game(task, result, true);
+    // Games cut short by a stop command are played again when the match is resumed.
+    if (!g_stop_match) g_match_journal.record(task.game_id, result);
+
+    // Increment total games completed and send universal updates
+    int completed_count = ++g_games_completed;
+
+    if (g_tournament_mode == TournamentMode::MATCH) {
         send_info_string(std::format("Game {} Finished. Score: E1 {:.1f} - E2 {:.1f} (Draws: {})",
-                                     task.game_id, g_score_engine1.load(), g_score_engine2.load(),
-                                     g_draws.load()));
+                                     task.game_id, g_score_engine1.load(),
+                                     g_score_engine2.load(), g_draws.load()));
+    } else {
+        send_info_string(std::format("Game {} Finished. {}", task.game_id,
+                                     g_standings.pairing_summary(task.pairing)));
+        if (pairing_games == 2 * g_rounds) {
+            report_standings(std::format("Standings after {} of {} games:", completed_count,
+                                         g_total_games));
+        }
+    }
+
+    // These are global stats, so any worker can send them. The GUI will just
+    // update.
+    send_to_gui(std::format("info game {}/{}", completed_count, g_total_games));
+    send_to_gui(std::format("info wld {}-{}-{}", g_wins_engine1.load(), g_losses_engine1.load(),
+                            g_draws.load()));
+}
+
+void worker(int worker_id) {
+    // Worker nodes have no GUI to show a game to.
+    bool is_primary_worker = worker_id == 0 && !g_coordinator_link;
+    // Engine processes owned by this worker, reused from game to game.
+    EnginePool engine_pool;
+
+    while (true) {
+        if (g_stop_match) {
+            // No need for info string here, will be spammy if many workers exist
+            return;
+        }
+
+        GameTask task;
+        if (!next_game_task(worker_id, task)) {
+            return;
+        }
 
-        // These are global stats, so any worker can send them. The GUI will just
-        // update.
-        send_to_gui(std::format("info game {}/{}", completed_count, total_games));
-        send_to_gui(std::format("info wld {}-{}-{}", g_wins_engine1.load(), g_losses_engine1.load(),
-                                g_draws.load()));
+        announce_game(task, worker_id, is_primary_worker);
+
+        // Pass the primary flag to play_game
+        Color result = play_game(task, worker_id, is_primary_worker, engine_pool);
+        record_game_result(task, result);
     }
 }
 
@@ -321,35 +472,58 @@ void worker(int worker_id) {
 
 // Function to load the FEN book from a file.
 void load_fen_book() {
-    g_fen_book.clear();
+    g_fen_book.close();
     if (g_book_file_path.empty()) {
         return;  // No book file provided, will use default FEN.
     }
 
-    std::ifstream file(g_book_file_path);
-    if (!file.is_open()) {
-        send_info_string("Warning: Could not open BookFile: " + g_book_file_path +
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    if (!g_fen_book.open(g_book_file_path, error)) {
+        send_info_string("Warning: Could not load BookFile: " + error +
                          ". Using default position.");
         return;
     }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        // Simple validation: ignore empty lines.
-        if (!line.empty()) {
-            g_fen_book.push_back(line);
-        }
-    }
-    file.close();
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
 
     if (g_fen_book.empty()) {
         send_info_string("Warning: BookFile is empty. Using default position.");
     } else {
-        send_info_string(
-            std::format("Successfully loaded {} FENs from BookFile.", g_fen_book.size()));
+        const char *index_note = g_fen_book.is_binary()          ? "binary book"
+                                 : g_fen_book.used_cached_index() ? "cached index"
+                                 : g_fen_book.saved_index()       ? "index built and saved"
+                                                                  : "index built, not saved";
+        send_info_string(std::format("Successfully loaded {} FENs from BookFile in {} ms ({}).",
+                                     g_fen_book.size(), elapsed_ms, index_note));
     }
 }
 
+// Sets up the cores of `slots` game slots if CpuAffinity is enabled.
+void plan_slot_affinity(int slots) {
+    g_slot_affinity.clear();
+    if (!g_cpu_affinity) return;
+    std::vector<CpuSet> cores = detect_physical_cores();
+    if (cores.empty()) {
+        send_info_string("Warning: CPU topology unavailable, engines are not pinned.");
+        return;
+    }
+    if (static_cast<size_t>(slots) * g_cores_per_game > cores.size()) {
+        send_info_string(std::format(
+            "Warning: {} games x {} cores exceed the {} physical cores; cores are shared.", slots,
+            g_cores_per_game, cores.size()));
+    }
+    if (g_cores_per_game > 1 && g_cores_per_game % 2 != 0) {
+        send_info_string(std::format(
+            "Warning: CoresPerGame {} is odd; each engine gets {} core(s) and one is left idle.",
+            g_cores_per_game, g_cores_per_game / 2));
+    }
+    g_slot_affinity = plan_affinity(cores, slots, g_cores_per_game);
+    send_info_string(std::format("Pinning engines to {} core(s) per game ({} available).",
+                                 g_cores_per_game, cores.size()));
+}
+
 void run_tournament() {
     g_stop_match = false;
     g_score_engine1 = 0.0;
@@ -358,46 +532,163 @@ void run_tournament() {
     g_wins_engine1 = 0;
     g_losses_engine1 = 0;
     g_games_completed = 0;
+    std::uint64_t dropped_log_lines = Logger::dropped_lines();
+    g_latency_stats.reset();
+    g_sprt = Sprt(g_sprt_config);
+    g_sprt_result = SprtResult::CONTINUE;
+    g_sprt_open_pairs.clear();
 
     // Load the book at the start of the match.
     load_fen_book();
 
-    if (!g_fen_book.empty()) {
-        send_info_string("Shuffling FEN book...");
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(g_fen_book.begin(), g_fen_book.end(), g);
-    }
-
-    int total_games = g_rounds * 2;
-    send_info_string("Populating game queue...");
-    {
-        std::lock_guard<std::mutex> lock(g_queue_mutex);
-        g_game_queue.clear();
-        for (int i = 0; i < g_rounds; ++i) {
-            // Get the next FEN sequentially from the shuffled book, wrapping around
-            // if necessary.
-            std::string start_pos_fen =
-                g_fen_book.empty()
-                    ? "xxxxkxxxx/9/1x5x1/x1x1x1x1x/9/9/X1X1X1X1X/1X5X1/9/XXXXKXXXX w "
-                      "R2r2N2n2B2b2A2a2C2c2P5p5 0 1"
-                    : g_fen_book[i % g_fen_book.size()];
-
-            g_game_queue.push_back({i * 2 + 1, g_engine1_path, g_engine2_path, g_engine1_options,
-                                    g_engine2_options, start_pos_fen, true});
-            g_game_queue.push_back({i * 2 + 2, g_engine2_path, g_engine1_path, g_engine2_options,
-                                    g_engine1_options, start_pos_fen, false});
+    // Engine1 and Engine2 play a match; round-robins and gauntlets add the
+    // ExtraEngines.
+    g_players = {{g_engine1_path, g_engine1_options, ""}, {g_engine2_path, g_engine2_options, ""}};
+    if (g_tournament_mode != TournamentMode::MATCH) {
+        std::vector<Player> extra = parse_players(g_extra_engines);
+        g_players.insert(g_players.end(), extra.begin(), extra.end());
+    }
+    name_players(g_players);
+    g_pairings = make_pairings(g_tournament_mode, static_cast<int>(g_players.size()));
+    g_standings.reset(g_players, g_pairings);
+    g_total_games = static_cast<std::int64_t>(g_rounds) * 2 * g_pairings.size();
+    if (g_tournament_mode != TournamentMode::MATCH) {
+        send_info_string(std::format(
+            "{} of {} engines: {} pairing(s) of {} round(s).",
+            g_tournament_mode == TournamentMode::ROUND_ROBIN ? "Round-robin" : "Gauntlet",
+            g_players.size(), g_pairings.size(), g_rounds));
+    }
+    // The seed and these settings fix the schedule of every game.
+    std::string schedule = std::format("{}|{}|{}|{}|{}", static_cast<int>(g_tournament_mode),
+                                       g_rounds, g_paired_flips, g_book_file_path,
+                                       g_fen_book.size());
+    for (const Player &player : g_players) {
+        schedule += std::format("|{}|{}", player.path, player.options);
+    }
+    JournalHeader journal{};
+    std::memcpy(journal.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    journal.version = JOURNAL_VERSION;
+    journal.fingerprint = journal_fingerprint(schedule);
+    journal.total_games = g_total_games;
+
+    // ResumeFrom applies to one startmatch only; later matches start afresh.
+    std::string resume_from = std::exchange(g_resume_from, {});
+    std::vector<JournalEntry> finished_games;
+    if (!resume_from.empty()) {
+        JournalHeader resumed;
+        std::string error;
+        if (!g_match_journal.resume(resume_from, resumed, finished_games, error)) {
+            send_info_string(std::format("Error: Cannot resume the match: {}.", error));
+            send_info_string("Tournament stopped prematurely.");
+            return;
         }
+        if (resumed.fingerprint != journal.fingerprint ||
+            resumed.total_games != journal.total_games) {
+            g_match_journal.close();
+            send_info_string(std::format(
+                "Error: {} belongs to a match with other engines, rounds or book.",
+                resume_from));
+            send_info_string("Tournament stopped prematurely.");
+            return;
+        }
+        g_match_seed = resumed.seed;
+        send_info_string(std::format("Resuming the match of seed {} from {}: {} game(s) finished.",
+                                     g_match_seed, resume_from, finished_games.size()));
+    } else {
+        // The seed fixes the openings and every flip; print it so the match can be rerun.
+        // A random seed stays within the range of the Seed option, and is never 0.
+        g_match_seed = g_seed;
+        while (g_match_seed == 0) g_match_seed = std::random_device{}() & 0x7FFFFFFF;
+        send_info_string(std::format("Using seed {}.", g_match_seed));
+        if (!g_checkpoint_dir.empty()) {
+            journal.seed = g_match_seed;
+            std::string path = std::format("{}/match_{}.jqj", g_checkpoint_dir, g_match_seed);
+            std::string error;
+            if (g_match_journal.create(path, journal, error)) {
+                send_info_string(std::format("Checkpointing finished games to {}.", path));
+            } else {
+                send_info_string(std::format("Warning: {}. The match cannot be resumed.", error));
+            }
+        }
+    }
+
+    // Each match archives its games in a file named after its seed.
+    std::string notation_path;
+    if (g_save_notation) {
+        notation_path = g_notation_format == NotationFormat::ARCHIVE
+                            ? std::format("{}/match_{}.jqa", g_save_notation_dir, g_match_seed)
+                            : g_save_notation_dir;
+        std::string error;
+        if (!g_game_archive.open(g_notation_format, notation_path, g_notation_compression,
+                                 error)) {
+            send_info_string(std::format("Warning: {}. Games are not saved.", error));
+        }
+    }
+
+    if (g_sprt_enabled && g_pairings.size() > 1) {
+        send_info_string("Warning: SPRT needs a single pairing and is skipped.");
+    }
+
+    // Games finished before a resume are scored again from the journal and
+    // skipped by the scheduler.
+    std::vector<bool> finished(g_total_games, false);
+    for (const JournalEntry &entry : finished_games) {
+        std::int64_t game = static_cast<std::int64_t>(entry.game_id) - 1;
+        if (game < 0 || game >= g_total_games || finished[game]) continue;
+        finished[game] = true;
+        GameTask task{};
+        task.game_id = entry.game_id;
+        task.red_is_first = game % 2 == 0;
+        task.pairing = static_cast<int>(game / 2 / g_rounds);
+        score_game(task, journal_result(entry), false);
+        g_games_completed++;
+    }
+
+    // Games are generated on demand as workers ask for them.
+    g_game_scheduler.start(g_rounds * static_cast<std::int64_t>(g_pairings.size()),
+                           g_concurrency, std::move(finished));
+    if (g_games_completed > 0 && g_sprt_enabled && g_pairings.size() == 1) {
+        send_info_string("SPRT " + g_sprt.summary());
+        if (g_sprt_result != SprtResult::CONTINUE) g_game_scheduler.stop();
+    }
+
+    send_to_gui(std::format("info game {}/{}", g_games_completed.load(), g_total_games));
+    send_to_gui(std::format("info wld {}-{}-{}", g_wins_engine1.load(), g_losses_engine1.load(),
+                            g_draws.load()));
+    bool coordinate = !g_listen_address.empty();
+    if (coordinate && !distributed_supported()) {
+        send_info_string("Warning: Worker nodes are not supported here. Playing locally.");
+        coordinate = false;
     }
+    if (!coordinate) plan_slot_affinity(g_concurrency);
 
-    send_to_gui(std::format("info game 0/{}", total_games));
-    send_to_gui("info wld 0-0-0");
-    send_info_string(std::format("Match started with {} worker(s).", g_concurrency));
+    bool use_reactor = g_scheduler == "Reactor";
+    if (use_reactor && !reactor_supported()) {
+        send_info_string("Warning: Scheduler Reactor is not supported here. Using threads.");
+        use_reactor = false;
+    }
 
     std::vector<std::thread> workers;
-    for (int i = 0; i < g_concurrency; ++i) {
-        // Pass worker_id to the thread constructor
-        workers.emplace_back(worker, i);
+    if (coordinate) {
+        // Worker nodes play the games; Concurrency caps their game slots.
+        run_coordinator(
+            {g_listen_address, g_concurrency, g_lease_ms, g_match_seed, g_node_options});
+    } else if (use_reactor) {
+        // Spread the game slots evenly over the reactor threads.
+        int threads = std::clamp(g_reactor_threads, 1, g_concurrency);
+        send_info_string(std::format("Match started with {} game slot(s) on {} reactor thread(s).",
+                                     g_concurrency, threads));
+        for (int i = 0, first_slot = 0; i < threads; ++i) {
+            int slot_count = g_concurrency / threads + (i < g_concurrency % threads ? 1 : 0);
+            workers.emplace_back(run_reactor, first_slot, slot_count);
+            first_slot += slot_count;
+        }
+    } else {
+        send_info_string(std::format("Match started with {} worker(s).", g_concurrency));
+        for (int i = 0; i < g_concurrency; ++i) {
+            // Pass worker_id to the thread constructor
+            workers.emplace_back(worker, i);
+        }
     }
 
     for (auto &w : workers) {
@@ -409,6 +700,30 @@ void run_tournament() {
     } else {
         send_info_string("Tournament finished!");
     }
+    if (g_tournament_mode != TournamentMode::MATCH) {
+        report_standings("Final standings:");
+    }
+    if (g_sprt_enabled && g_pairings.size() == 1) {
+        const char *verdict = g_sprt_result == SprtResult::ACCEPT_H1   ? "H1 accepted"
+                              : g_sprt_result == SprtResult::ACCEPT_H0 ? "H0 accepted"
+                                                                       : "inconclusive";
+        send_info_string(std::format("SPRT result: {}. {}", verdict, g_sprt.summary()));
+    }
+    g_latency_stats.report();
+    if (g_save_notation) {
+        g_game_archive.close();
+        send_info_string(std::format("Saved {} game(s) to {}.", g_game_archive.games_written(),
+                                     notation_path));
+        if (g_game_archive.games_failed() > 0) {
+            send_info_string(std::format("Warning: {} game(s) could not be saved.",
+                                         g_game_archive.games_failed()));
+        }
+    }
+    g_match_journal.close();
+    if (Logger::dropped_lines() > dropped_log_lines) {
+        send_info_string(std::format("Warning: {} log lines were dropped (logger queue full).",
+                                     Logger::dropped_lines() - dropped_log_lines));
+    }
     // Send final WLD
     send_to_gui(std::format("info wld {}-{}-{}", g_wins_engine1.load(), g_losses_engine1.load(),
                             g_draws.load()));
@@ -423,15 +738,37 @@ void handle_jai() {
     send_to_gui("option name Engine1Options type string");
     send_to_gui("option name Engine2Path type string");
     send_to_gui("option name Engine2Options type string");
+    send_to_gui("option name TournamentMode type combo default Match var Match var RoundRobin "
+                "var Gauntlet");
+    send_to_gui("option name ExtraEngines type string");
     send_to_gui("option name BookFile type string");
     send_to_gui("option name SaveNotation type check default false");
     send_to_gui("option name SaveNotationDir type string");
-    send_to_gui("option name TotalRounds type spin default 10 min 1 max 1000");
-    send_to_gui("option name Concurrency type spin default 2 min 1 max 128");
+    send_to_gui("option name NotationFormat type combo default Archive var Archive var Json");
+    send_to_gui("option name NotationCompression type check default true");
+    send_to_gui("option name TotalRounds type spin default 10 min 1 max 10000000");
+    send_to_gui("option name Concurrency type spin default 2 min 1 max 1024");
+    send_to_gui("option name Scheduler type combo default Threads var Threads var Reactor");
+    send_to_gui("option name ReactorThreads type spin default 1 min 1 max 64");
+    send_to_gui("option name CpuAffinity type check default false");
+    send_to_gui("option name CoresPerGame type spin default 1 min 1 max 256");
     send_to_gui("option name MainTimeMs type spin default 1000 min 0 max 3600000");
     send_to_gui("option name IncTimeMs type spin default 0 min 0 max 60000");
     send_to_gui("option name TimeoutBufferMs type spin default 5000 min 0 max 60000");
+    send_to_gui("option name Seed type spin default 0 min 0 max 2147483647");
+    send_to_gui("option name PairedFlips type check default false");
+    send_to_gui("option name GuiInfo type combo default PerDepth var All var PerDepth var Latest");
+    send_to_gui("option name GuiInfoIntervalMs type spin default 100 min 0 max 10000");
     send_to_gui("option name Logging type check default false");
+    send_to_gui("option name SPRT type check default false");
+    send_to_gui("option name SPRTElo0 type string default 0");
+    send_to_gui("option name SPRTElo1 type string default 5");
+    send_to_gui("option name SPRTAlpha type string default 0.05");
+    send_to_gui("option name SPRTBeta type string default 0.05");
+    send_to_gui("option name CheckpointDir type string default checkpoints");
+    send_to_gui("option name ResumeFrom type string");
+    send_to_gui("option name Listen type string");
+    send_to_gui("option name LeaseMs type spin default 10000 min 1000 max 600000");
 
     send_to_gui("jaiok");
 }
@@ -448,6 +785,21 @@ void handle_setoption(const std::string &line) {
 
     if (name_token != "name" || value_token != "value") return;
 
+    // Options that change how games are played are passed on to worker nodes.
+    static constexpr std::string_view NODE_OPTIONS[] = {
+        "MainTimeMs", "IncTimeMs", "TimeoutBufferMs", "CpuAffinity",
+        "CoresPerGame", "SaveNotation", "Logging"};
+    if (std::find(std::begin(NODE_OPTIONS), std::end(NODE_OPTIONS), option_name) !=
+        std::end(NODE_OPTIONS)) {
+        auto it = std::find_if(g_node_options.begin(), g_node_options.end(),
+                               [&](const auto &option) { return option.first == option_name; });
+        if (it != g_node_options.end()) {
+            it->second = option_value;
+        } else {
+            g_node_options.emplace_back(option_name, option_value);
+        }
+    }
+
     if (option_name == "Engine1Path")
         g_engine1_path = option_value;
     else if (option_name == "Engine2Path")
@@ -456,27 +808,151 @@ void handle_setoption(const std::string &line) {
         g_engine1_options = option_value;
     else if (option_name == "Engine2Options")
         g_engine2_options = option_value;
+    else if (option_name == "TournamentMode")
+        g_tournament_mode = option_value == "RoundRobin" ? TournamentMode::ROUND_ROBIN
+                            : option_value == "Gauntlet" ? TournamentMode::GAUNTLET
+                                                         : TournamentMode::MATCH;
+    else if (option_name == "ExtraEngines")
+        g_extra_engines = option_value;
     else if (option_name == "BookFile")
         g_book_file_path = option_value;
     else if (option_name == "SaveNotation")
         g_save_notation = (option_value == "true");
     else if (option_name == "SaveNotationDir")
         g_save_notation_dir = option_value;
+    else if (option_name == "NotationFormat")
+        g_notation_format = option_value == "Json" ? NotationFormat::JSON : NotationFormat::ARCHIVE;
+    else if (option_name == "NotationCompression")
+        g_notation_compression = (option_value == "true");
     else if (option_name == "TotalRounds")
         g_rounds = std::stoi(option_value);
     else if (option_name == "Concurrency")
         g_concurrency = std::stoi(option_value);
+    else if (option_name == "Scheduler")
+        g_scheduler = option_value;
+    else if (option_name == "ReactorThreads")
+        g_reactor_threads = std::stoi(option_value);
+    else if (option_name == "CpuAffinity")
+        g_cpu_affinity = (option_value == "true");
+    else if (option_name == "CoresPerGame")
+        g_cores_per_game = std::stoi(option_value);
     else if (option_name == "MainTimeMs")
         g_tc.wtime_ms = g_tc.btime_ms = std::stoi(option_value);
     else if (option_name == "IncTimeMs")
         g_tc.winc_ms = g_tc.binc_ms = std::stoi(option_value);
     else if (option_name == "TimeoutBufferMs")
         g_timeout_buffer_ms = std::stoi(option_value);
+    else if (option_name == "Seed")
+        g_seed = std::stoull(option_value);
+    else if (option_name == "PairedFlips")
+        g_paired_flips = (option_value == "true");
+    else if (option_name == "GuiInfo")
+        g_gui_info_mode = option_value == "All"      ? GuiInfoMode::ALL
+                          : option_value == "Latest" ? GuiInfoMode::LATEST
+                                                     : GuiInfoMode::PER_DEPTH;
+    else if (option_name == "GuiInfoIntervalMs")
+        g_gui_info_interval_ms = std::stoi(option_value);
     else if (option_name == "Logging")
         LoggerConfig::set_enabled(option_value == "true");
+    else if (option_name == "SPRT")
+        g_sprt_enabled = (option_value == "true");
+    else if (option_name == "SPRTElo0")
+        g_sprt_config.elo0 = std::stod(option_value);
+    else if (option_name == "SPRTElo1")
+        g_sprt_config.elo1 = std::stod(option_value);
+    else if (option_name == "SPRTAlpha")
+        g_sprt_config.alpha = std::stod(option_value);
+    else if (option_name == "SPRTBeta")
+        g_sprt_config.beta = std::stod(option_value);
+    else if (option_name == "CheckpointDir")
+        g_checkpoint_dir = option_value;
+    else if (option_name == "ResumeFrom")
+        g_resume_from = option_value;
+    else if (option_name == "Listen")
+        g_listen_address = option_value;
+    else if (option_name == "LeaseMs")
+        g_lease_ms = std::stoi(option_value);
 }
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+// --- Worker Node ---
+
+// Plays the games of one match after another for the coordinator at
+// `address`, on `slots` game slots, until the process is killed.
+void run_worker_node(const std::string &address, int slots) {
+    bool reported_wait = false;
+    while (true) {
+        CoordinatorLink link;
+        std::string error;
+        if (!link.connect(address, slots, error)) {
+            if (!reported_wait) {
+                send_info_string(std::format("Waiting for the coordinator ({}).", error));
+                reported_wait = true;
+            }
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+        reported_wait = false;
+
+        for (const auto &[name, value] : link.options()) {
+            handle_setoption(std::format("setoption name {} value {}", name, value));
+        }
+        g_match_seed = link.seed();
+        g_stop_match = false;
+        plan_slot_affinity(link.slots());
+        send_info_string(std::format("Connected to {}, playing on {} game slot(s).", address,
+                                     link.slots()));
+
+        g_coordinator_link = &link;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < link.slots(); ++i) {
+            workers.emplace_back(worker, i);
+        }
+        bool finished = link.run();
+        if (!finished) {
+            // Stopped, or the coordinator is gone: its games are handed to others.
+            g_stop_match = true;
+            stop_all_engines();
+        }
+        for (auto &w : workers) {
+            if (w.joinable()) w.join();
+        }
+        g_coordinator_link = nullptr;
+        send_info_string(finished ? "Match finished." : "Match stopped or connection lost.");
+    }
+}
+
+int main(int argc, char *argv[]) {
+#ifndef _WIN32
+    // Engines now outlive single games; writing to one that crashed while idle
+    // must fail with EPIPE instead of killing the arena.
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    // jieqi_arena --worker <address> [--slots <n>] runs a worker node.
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() >= 2 && args[0] == "--worker") {
+        int slots = std::max(1, static_cast<int>(std::thread::hardware_concurrency() / 2));
+        if (args.size() > 2) {
+            bool valid = args.size() == 4 && args[2] == "--slots";
+            if (valid) {
+                const std::string &value = args[3];
+                auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), slots);
+                valid = ec == std::errc() && end == value.data() + value.size() && slots >= 1;
+            }
+            if (!valid) {
+                std::cerr << "Usage: jieqi_arena --worker <address> [--slots <n>], with n >= 1"
+                          << std::endl;
+                return 1;
+            }
+        }
+        if (!distributed_supported()) {
+            std::cerr << "Worker nodes are not supported on this platform." << std::endl;
+            return 1;
+        }
+        run_worker_node(args[1], slots);
+        return 0;
+    }
+
     std::string line;
     while (std::getline(std::cin, line)) {
         std::stringstream ss(line);
@@ -504,11 +980,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
             g_stop_match = true;
             // Stop all active engines immediately
             stop_all_engines();
-            // Clear the game queue to stop all pending games immediately
-            {
-                std::lock_guard<std::mutex> lock(g_queue_mutex);
-                g_game_queue.clear();
-            }
+            // Hand out no further games
+            g_game_scheduler.stop();
             if (g_tournament_thread.joinable()) {
                 g_tournament_thread.join();
             }
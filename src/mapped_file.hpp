@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// --- Memory-Mapped Files ---
+
+// Read-only view of a whole file. Pages are loaded by the OS on first access,
+// so opening even a very large file is immediate.
+class MappedFile {
+   private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_handle_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_handle_ = NULL;
+#endif
+
+   public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Maps `path`. Returns false if it cannot be opened. An empty file maps
+    // successfully to an empty view.
+    bool open(const std::string &path);
+    void close();
+
+    const char *data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return {data_, size_}; }
+};
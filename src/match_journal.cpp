@@ -0,0 +1,142 @@
+#include "match_journal.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::uint64_t fnv1a64(const void *data, size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    std::uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::uint16_t entry_checksum(const JournalEntry &entry) {
+    return static_cast<std::uint16_t>(fnv1a64(&entry, offsetof(JournalEntry, checksum)));
+}
+
+}  // namespace
+
+std::uint64_t journal_fingerprint(std::string_view settings) {
+    return fnv1a64(settings.data(), settings.size());
+}
+
+Color journal_result(const JournalEntry &entry) {
+    if (entry.result == JOURNAL_RED_WINS) return Color::RED;
+    if (entry.result == JOURNAL_BLACK_WINS) return Color::BLACK;
+    return Color::NONE;
+}
+
+MatchJournal::~MatchJournal() {
+    close();
+}
+
+bool MatchJournal::create(const std::string &path, const JournalHeader &header,
+                          std::string &error) {
+    close();
+    std::error_code ec;
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    if (!directory.empty()) std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        error = std::format("Cannot create directory {}: {}", directory.string(), ec.message());
+        return false;
+    }
+
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f || std::fwrite(&header, sizeof(header), 1, f) != 1 || std::fflush(f) != 0) {
+        error = std::format("Cannot write {}: {}", path, std::strerror(errno));
+        if (f) std::fclose(f);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file = f;
+    sync();
+    return true;
+}
+
+bool MatchJournal::resume(const std::string &path, JournalHeader &header,
+                          std::vector<JournalEntry> &games, std::string &error) {
+    close();
+    games.clear();
+    std::FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        error = std::format("Cannot open {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    bool valid = std::fread(&header, sizeof(header), 1, f) == 1 &&
+                 std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 &&
+                 header.version == JOURNAL_VERSION;
+    if (!valid) {
+        std::fclose(f);
+        error = std::format("{} is not a match journal", path);
+        return false;
+    }
+
+    // Entries are read up to the first one a crash left incomplete or garbled.
+    JournalEntry entry;
+    while (std::fread(&entry, sizeof(entry), 1, f) == 1 &&
+           entry.checksum == entry_checksum(entry)) {
+        games.push_back(entry);
+    }
+    std::fclose(f);
+
+    std::error_code ec;
+    std::filesystem::resize_file(path, sizeof(header) + games.size() * sizeof(JournalEntry), ec);
+    f = ec ? nullptr : std::fopen(path.c_str(), "ab");
+    if (!f) {
+        error = std::format("Cannot append to {}: {}", path,
+                            ec ? ec.message() : std::string(std::strerror(errno)));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file = f;
+    return true;
+}
+
+void MatchJournal::record(int game_id, Color result) {
+    JournalEntry entry{};
+    entry.game_id = static_cast<std::uint32_t>(game_id);
+    entry.result = result == Color::RED     ? JOURNAL_RED_WINS
+                   : result == Color::BLACK ? JOURNAL_BLACK_WINS
+                                            : JOURNAL_DRAW;
+    entry.checksum = entry_checksum(entry);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return;
+    std::fwrite(&entry, sizeof(entry), 1, file);
+    std::fflush(file);
+    if (Clock::now() - last_sync >= JOURNAL_SYNC_INTERVAL) sync();
+}
+
+void MatchJournal::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return;
+    sync();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void MatchJournal::sync() {
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+    last_sync = Clock::now();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "types.hpp"
+
+// --- Match Journal ---
+// A checkpoint of the match in progress, from which a crashed or stopped
+// match is resumed without playing its finished games again. The header
+// fixes the schedule: the seed determines the opening and flips of every
+// game, and the fingerprint the engines, pairings, rounds and book they are
+// played with. It is followed by one entry per finished game, appended when
+// the game's result comes in.
+
+struct JournalHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t seed;
+    std::uint64_t fingerprint;  // journal_fingerprint() of the match settings
+    std::int64_t total_games;
+};
+static_assert(sizeof(JournalHeader) == 40);
+
+struct JournalEntry {
+    std::uint32_t game_id;
+    std::uint8_t result;  // JOURNAL_RED_WINS, JOURNAL_BLACK_WINS or JOURNAL_DRAW
+    std::uint8_t reserved;
+    std::uint16_t checksum;  // Low bits of the FNV-1a of the fields above
+};
+static_assert(sizeof(JournalEntry) == 8);
+
+constexpr char JOURNAL_MAGIC[8] = {'J', 'Q', 'J', 'R', 'N', 'L', '0', '1'};
+constexpr std::uint32_t JOURNAL_VERSION = 1;
+constexpr std::uint8_t JOURNAL_DRAW = 0;
+constexpr std::uint8_t JOURNAL_RED_WINS = 1;
+constexpr std::uint8_t JOURNAL_BLACK_WINS = 2;
+
+// A 64-bit hash of the settings that make up a match's schedule.
+std::uint64_t journal_fingerprint(std::string_view settings);
+
+Color journal_result(const JournalEntry &entry);
+
+// Appends finished games to a journal. Each entry is written through to the
+// operating system at once, so killing the arena loses nothing; it is
+// flushed to disk at most once per JOURNAL_SYNC_INTERVAL, and on close.
+class MatchJournal {
+   private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr auto JOURNAL_SYNC_INTERVAL = std::chrono::seconds(1);
+
+    std::mutex mutex;
+    std::FILE *file = nullptr;
+    Clock::time_point last_sync;
+
+    void sync();
+
+   public:
+    MatchJournal() = default;
+    ~MatchJournal();
+    MatchJournal(const MatchJournal &) = delete;
+    MatchJournal &operator=(const MatchJournal &) = delete;
+
+    // Starts a new journal at `path`, replacing any file there, and creates
+    // its directory. Returns false with `error` set on failure.
+    bool create(const std::string &path, const JournalHeader &header, std::string &error);
+
+    // Opens the journal of an earlier match to continue it: reads its header
+    // and finished games, cuts off an entry torn by a crash, and appends to
+    // the file from then on.
+    bool resume(const std::string &path, JournalHeader &header,
+                std::vector<JournalEntry> &games, std::string &error);
+
+    // Appends a finished game. Does nothing while no journal is open.
+    void record(int game_id, Color result);
+
+    // Flushes everything to disk and closes the file.
+    void close();
+};
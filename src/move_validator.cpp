@@ -5,133 +5,99 @@
 #include <optional>
 #include <stdexcept>
 
-// Initialize the static initial board layout
-const Board MoveValidator::initial_board_layout = {
-    {Piece::BLK_ROOK, Piece::BLK_KNIGHT, Piece::BLK_BISHOP, Piece::BLK_ADVISOR, Piece::BLK_KING,
-     Piece::BLK_ADVISOR, Piece::BLK_BISHOP, Piece::BLK_KNIGHT, Piece::BLK_ROOK},
-    {Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY,
-     Piece::EMPTY, Piece::EMPTY, Piece::EMPTY},
-    {Piece::EMPTY, Piece::BLK_CANNON, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY,
-     Piece::EMPTY, Piece::BLK_CANNON, Piece::EMPTY},
-    {Piece::BLK_PAWN, Piece::EMPTY, Piece::BLK_PAWN, Piece::EMPTY, Piece::BLK_PAWN, Piece::EMPTY,
-     Piece::BLK_PAWN, Piece::EMPTY, Piece::BLK_PAWN},
-    {Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY,
-     Piece::EMPTY, Piece::EMPTY, Piece::EMPTY},
-    {Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY,
-     Piece::EMPTY, Piece::EMPTY, Piece::EMPTY},
-    {Piece::RED_PAWN, Piece::EMPTY, Piece::RED_PAWN, Piece::EMPTY, Piece::RED_PAWN, Piece::EMPTY,
-     Piece::RED_PAWN, Piece::EMPTY, Piece::RED_PAWN},
-    {Piece::EMPTY, Piece::RED_CANNON, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY,
-     Piece::EMPTY, Piece::RED_CANNON, Piece::EMPTY},
-    {Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY, Piece::EMPTY,
-     Piece::EMPTY, Piece::EMPTY, Piece::EMPTY},
-    {Piece::RED_ROOK, Piece::RED_KNIGHT, Piece::RED_BISHOP, Piece::RED_ADVISOR, Piece::RED_KING,
-     Piece::RED_ADVISOR, Piece::RED_BISHOP, Piece::RED_KNIGHT, Piece::RED_ROOK}};
+// Initialize the static initial board layout (one line per row, Black's back rank first)
+const std::array<Piece, BOARD_SQUARES> MoveValidator::initial_board_layout = {
+    // clang-format off
+    Piece::BLK_ROOK, Piece::BLK_KNIGHT, Piece::BLK_BISHOP, Piece::BLK_ADVISOR, Piece::BLK_KING, Piece::BLK_ADVISOR, Piece::BLK_BISHOP, Piece::BLK_KNIGHT, Piece::BLK_ROOK,
+    Piece::EMPTY,    Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,       Piece::EMPTY,    Piece::EMPTY,       Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,
+    Piece::EMPTY,    Piece::BLK_CANNON, Piece::EMPTY,      Piece::EMPTY,       Piece::EMPTY,    Piece::EMPTY,       Piece::EMPTY,      Piece::BLK_CANNON, Piece::EMPTY,
+    Piece::BLK_PAWN, Piece::EMPTY,      Piece::BLK_PAWN,   Piece::EMPTY,       Piece::BLK_PAWN, Piece::EMPTY,       Piece::BLK_PAWN,   Piece::EMPTY,      Piece::BLK_PAWN,
+    Piece::EMPTY,    Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,       Piece::EMPTY,    Piece::EMPTY,       Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,
+    Piece::EMPTY,    Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,       Piece::EMPTY,    Piece::EMPTY,       Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,
+    Piece::RED_PAWN, Piece::EMPTY,      Piece::RED_PAWN,   Piece::EMPTY,       Piece::RED_PAWN, Piece::EMPTY,       Piece::RED_PAWN,   Piece::EMPTY,      Piece::RED_PAWN,
+    Piece::EMPTY,    Piece::RED_CANNON, Piece::EMPTY,      Piece::EMPTY,       Piece::EMPTY,    Piece::EMPTY,       Piece::EMPTY,      Piece::RED_CANNON, Piece::EMPTY,
+    Piece::EMPTY,    Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,       Piece::EMPTY,    Piece::EMPTY,       Piece::EMPTY,      Piece::EMPTY,      Piece::EMPTY,
+    Piece::RED_ROOK, Piece::RED_KNIGHT, Piece::RED_BISHOP, Piece::RED_ADVISOR, Piece::RED_KING, Piece::RED_ADVISOR, Piece::RED_BISHOP, Piece::RED_KNIGHT, Piece::RED_ROOK,
+    // clang-format on
+};
 
-MoveValidator::MoveValidator() = default;
+namespace {
 
-std::pair<int, int> MoveValidator::coord_to_pos(const std::string &coord) {
-    if (coord.length() != 2) return {-1, -1};
-    int col = coord[0] - 'a';
-    int row = 9 - (coord[1] - '0');
-    if (row < 0 || row > 9 || col < 0 || col > 8) return {-1, -1};
-    return {row, col};
-}
+constexpr int ORTHOGONAL[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+constexpr int DIAGONAL[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+// Knight jumps as (row, col) offsets from the knight to its target.
+constexpr int KNIGHT_JUMPS[8][2] = {{-2, -1}, {-2, 1}, {2, -1}, {2, 1},
+                                    {-1, -2}, {1, -2}, {-1, 2}, {1, 2}};
 
-std::optional<Color> MoveValidator::get_piece_color(Piece p) {
-    if (p == Piece::EMPTY || p == Piece::HIDDEN) return std::nullopt;
-    if (p >= Piece::RED_KING && p <= Piece::RED_PAWN) return Color::RED;
-    return Color::BLACK;
+bool on_board(int r, int c) {
+    return r >= 0 && r < BOARD_ROWS && c >= 0 && c < BOARD_COLS;
 }
 
-bool MoveValidator::is_revealed(Piece p) {
-    return p != Piece::HIDDEN && p != Piece::EMPTY;
+bool in_palace(Color color, int r, int c) {
+    int palace_top = (color == Color::RED) ? 7 : 0;
+    return c >= 3 && c <= 5 && r >= palace_top && r <= palace_top + 2;
 }
 
-Piece MoveValidator::get_base_piece_type(Piece p) {
-    if (p >= Piece::BLK_KING && p <= Piece::BLK_PAWN) {
-        return static_cast<Piece>(static_cast<int>(p) - 7);
-    }
-    return p;
-}
+}  // namespace
+
+MoveValidator::MoveValidator() = default;
 
 int MoveValidator::count_pieces_between(int r1, int c1, int r2, int c2, const Board &board) const {
     int count = 0;
     if (r1 == r2) {  // Horizontal
         for (int c = std::min(c1, c2) + 1; c < std::max(c1, c2); ++c) {
-            if (board[r1][c] != Piece::EMPTY) count++;
+            if (board.piece_at(r1, c) != Piece::EMPTY) count++;
         }
     } else if (c1 == c2) {  // Vertical
         for (int r = std::min(r1, r2) + 1; r < std::max(r1, r2); ++r) {
-            if (board[r][c1] != Piece::EMPTY) count++;
+            if (board.piece_at(r, c1) != Piece::EMPTY) count++;
         }
     }
     return count;
 }
 
-std::optional<std::pair<int, int>> MoveValidator::find_king(Color king_color,
-                                                            const Board &board) const {
-    Piece king_to_find = (king_color == Color::RED) ? Piece::RED_KING : Piece::BLK_KING;
-    for (int r = 0; r < 10; ++r) {
-        for (int c = 0; c < 9; ++c) {
-            if (board[r][c] == king_to_find) {
-                return {{r, c}};
-            }
-        }
-    }
-    return std::nullopt;
-}
-
 bool MoveValidator::is_move_mechanically_valid(int r1, int c1, int r2, int c2,
                                                const Board &board) const {
-    Piece moving_piece = board[r1][c1];
+    Piece moving_piece = board.piece_at(r1, c1);
     if (moving_piece == Piece::EMPTY) return false;
+    if (r1 == r2 && c1 == c2) return false;
 
-    Piece target_piece = board[r2][c2];
-    auto moving_color = get_piece_color(moving_piece);
-    if (!moving_color && moving_piece != Piece::HIDDEN) return false;  // Should not happen
+    Piece target_piece = board.piece_at(r2, c2);
+    // In Jieqi, the color of a hidden piece is determined by its starting
+    // position. Red is on rows 5-9, Black on rows 0-4.
+    Color moving_color = board.owner(make_square(r1, c1));
 
     // Determine the effective role for hidden pieces
     Piece effective_role_piece = moving_piece;
     if (moving_piece == Piece::HIDDEN) {
-        effective_role_piece = initial_board_layout[r1][c1];
-        // In Jieqi, the moving color of a hidden piece is determined by its
-        // starting position. Red is on rows 0-4, Black on rows 5-9.
-        moving_color = (r1 > 4) ? Color::RED : Color::BLACK;
+        effective_role_piece = initial_board_layout[make_square(r1, c1)];
     }
 
-    // A piece cannot capture a piece of the same color
-    if (is_revealed(target_piece)) {
-        auto target_color = get_piece_color(target_piece);
-        if (target_color && target_color == moving_color) {
-            return false;
-        }
+    // A piece cannot capture a piece of the same color, hidden or not
+    if (board.owner(make_square(r2, c2)) == moving_color) {
+        return false;
     }
 
     int dRow = std::abs(r1 - r2);
     int dCol = std::abs(c1 - c2);
 
-    switch (get_base_piece_type(effective_role_piece)) {
+    switch (base_piece_type(effective_role_piece)) {
         case Piece::RED_KING: {
-            int palace_top = (moving_color == Color::RED) ? 7 : 0;
-            int palace_bottom = (moving_color == Color::RED) ? 9 : 2;
-            return (dRow + dCol == 1) && (c2 >= 3 && c2 <= 5) &&
-                   (r2 >= palace_top && r2 <= palace_bottom);
+            return (dRow + dCol == 1) && in_palace(moving_color, r2, c2);
         }
         case Piece::RED_ADVISOR: {
             if (is_revealed(moving_piece)) {  // Revealed advisor can leave palace
                 return dRow == 1 && dCol == 1;
             }
             // Hidden advisor is confined to palace
-            int palace_top = (moving_color == Color::RED) ? 7 : 0;
-            int palace_bottom = (moving_color == Color::RED) ? 9 : 2;
-            return dRow == 1 && dCol == 1 && (c2 >= 3 && c2 <= 5) &&
-                   (r2 >= palace_top && r2 <= palace_bottom);
+            return dRow == 1 && dCol == 1 && in_palace(moving_color, r2, c2);
         }
         case Piece::RED_BISHOP: {  // Elephant
             if (dRow != 2 || dCol != 2) return false;
             // Check for blocking piece (eye)
-            if (board[r1 + (r2 - r1) / 2][c1 + (c2 - c1) / 2] != Piece::EMPTY) return false;
+            if (board.piece_at(r1 + (r2 - r1) / 2, c1 + (c2 - c1) / 2) != Piece::EMPTY) {
+                return false;
+            }
             // Revealed elephants can cross the river. Hidden ones cannot.
             if (!is_revealed(moving_piece)) {
                 bool crosses_river = (moving_color == Color::RED && r2 <= 4) ||
@@ -145,7 +111,7 @@ bool MoveValidator::is_move_mechanically_valid(int r1, int c1, int r2, int c2,
             // Check for blocking piece (leg)
             int leg_r = r1 + (dRow == 2 ? (r2 - r1) / 2 : 0);
             int leg_c = c1 + (dCol == 2 ? (c2 - c1) / 2 : 0);
-            return board[leg_r][leg_c] == Piece::EMPTY;
+            return board.piece_at(leg_r, leg_c) == Piece::EMPTY;
         }
         case Piece::RED_ROOK: {
             if (dRow > 0 && dCol > 0) return false;
@@ -174,103 +140,206 @@ bool MoveValidator::is_move_mechanically_valid(int r1, int c1, int r2, int c2,
     }
 }
 
-bool MoveValidator::is_in_check(Color king_color, const Board &board) const {
-    auto king_pos_opt = find_king(king_color, board);
-    if (!king_pos_opt) return true;  // King is captured, which is a game-ending state.
-    auto [king_r, king_c] = *king_pos_opt;
+template <typename Visitor>
+bool MoveValidator::visit_pseudo_legal_moves(Color side, const Board &board,
+                                             Visitor &&visit) const {
+    Bitboard own = board.pieces(side);
+    while (own) {
+        int from = pop_lsb(own);
+        int r1 = square_row(from), c1 = square_col(from);
+        Piece p = board.piece_at(from);
+        bool revealed = is_revealed(p);
+        Piece role = base_piece_type(revealed ? p : initial_board_layout[from]);
 
-    Color opponent_color = (king_color == Color::RED) ? Color::BLACK : Color::RED;
+        // Visits the move to (r2, c2) unless an own piece stands there.
+        auto emit = [&](int r2, int c2) {
+            int to = make_square(r2, c2);
+            return board.owner(to) != side && visit(Move{from, to});
+        };
 
-    for (int r = 0; r < 10; ++r) {
-        for (int c = 0; c < 9; ++c) {
-            Piece p = board[r][c];
-            if (!is_revealed(p)) continue;
-
-            auto piece_color = get_piece_color(p);
-            if (piece_color == opponent_color) {
-                // Special "Flying King (General)" rule
-                if (get_base_piece_type(p) == Piece::RED_KING) {
-                    if (c == king_c && count_pieces_between(r, c, king_r, king_c, board) == 0) {
-                        return true;
+        switch (role) {
+            case Piece::RED_KING:
+                for (const auto &[dr, dc] : ORTHOGONAL) {
+                    int r2 = r1 + dr, c2 = c1 + dc;
+                    if (in_palace(side, r2, c2) && emit(r2, c2)) return true;
+                }
+                break;
+            case Piece::RED_ADVISOR:
+                for (const auto &[dr, dc] : DIAGONAL) {
+                    int r2 = r1 + dr, c2 = c1 + dc;
+                    if (!on_board(r2, c2)) continue;
+                    // Hidden advisors are confined to the palace
+                    if (!revealed && !in_palace(side, r2, c2)) continue;
+                    if (emit(r2, c2)) return true;
+                }
+                break;
+            case Piece::RED_BISHOP:
+                for (const auto &[dr, dc] : DIAGONAL) {
+                    int r2 = r1 + 2 * dr, c2 = c1 + 2 * dc;
+                    if (!on_board(r2, c2)) continue;
+                    if (board.piece_at(r1 + dr, c1 + dc) != Piece::EMPTY) continue;  // Eye
+                    // Hidden elephants cannot cross the river
+                    if (!revealed && (side == Color::RED ? r2 <= 4 : r2 >= 5)) continue;
+                    if (emit(r2, c2)) return true;
+                }
+                break;
+            case Piece::RED_KNIGHT:
+                for (const auto &[dr, dc] : KNIGHT_JUMPS) {
+                    int r2 = r1 + dr, c2 = c1 + dc;
+                    if (!on_board(r2, c2)) continue;
+                    int leg_r = r1 + (dr == 2 || dr == -2 ? dr / 2 : 0);
+                    int leg_c = c1 + (dc == 2 || dc == -2 ? dc / 2 : 0);
+                    if (board.piece_at(leg_r, leg_c) != Piece::EMPTY) continue;
+                    if (emit(r2, c2)) return true;
+                }
+                break;
+            case Piece::RED_ROOK:
+            case Piece::RED_CANNON:
+                for (const auto &[dr, dc] : ORTHOGONAL) {
+                    int r2 = r1 + dr, c2 = c1 + dc;
+                    // Quiet moves, and the rook's capture of the first blocker
+                    for (; on_board(r2, c2); r2 += dr, c2 += dc) {
+                        if (board.piece_at(r2, c2) == Piece::EMPTY) {
+                            if (emit(r2, c2)) return true;
+                            continue;
+                        }
+                        if (role == Piece::RED_ROOK && emit(r2, c2)) return true;
+                        break;
                     }
-                } else {
-                    if (is_move_mechanically_valid(r, c, king_r, king_c, board)) {
-                        return true;
+                    if (role == Piece::RED_ROOK) continue;
+                    // The cannon captures the first piece behind the screen
+                    for (r2 += dr, c2 += dc; on_board(r2, c2); r2 += dr, c2 += dc) {
+                        if (board.piece_at(r2, c2) != Piece::EMPTY) {
+                            if (emit(r2, c2)) return true;
+                            break;
+                        }
                     }
                 }
+                break;
+            case Piece::RED_PAWN: {
+                int forward_dir = (side == Color::RED) ? -1 : 1;
+                if (on_board(r1 + forward_dir, c1) && emit(r1 + forward_dir, c1)) return true;
+                bool has_crossed_river = (side == Color::RED) ? r1 <= 4 : r1 >= 5;
+                if (has_crossed_river) {
+                    if (c1 > 0 && emit(r1, c1 - 1)) return true;
+                    if (c1 < BOARD_COLS - 1 && emit(r1, c1 + 1)) return true;
+                }
+                break;
             }
+            default:
+                break;
         }
     }
     return false;
 }
 
-bool MoveValidator::would_be_in_check_after_move(int r1, int c1, int r2, int c2, Color moving_color,
-                                                 const Board &board) const {
-    Board temp_board = board;
-    temp_board[r2][c2] = temp_board[r1][c1];
-    temp_board[r1][c1] = Piece::EMPTY;
-    return is_in_check(moving_color, temp_board);
+bool MoveValidator::is_square_attacked(int sq, Color by, const Board &board) const {
+    int r = square_row(sq), c = square_col(sq);
+    auto has = [&](int r2, int c2, Piece red_type) {
+        return on_board(r2, c2) && board.piece_at(r2, c2) == make_piece(red_type, by);
+    };
+
+    // Rooks and the flying king hit the first piece on a line, cannons the second.
+    for (const auto &[dr, dc] : ORTHOGONAL) {
+        int r2 = r + dr, c2 = c + dc;
+        while (on_board(r2, c2) && board.piece_at(r2, c2) == Piece::EMPTY) {
+            r2 += dr;
+            c2 += dc;
+        }
+        if (!on_board(r2, c2)) continue;
+        if (has(r2, c2, Piece::RED_ROOK)) return true;
+        // Special "Flying King (General)" rule
+        if (dc == 0 && has(r2, c2, Piece::RED_KING)) return true;
+        for (r2 += dr, c2 += dc; on_board(r2, c2); r2 += dr, c2 += dc) {
+            if (board.piece_at(r2, c2) != Piece::EMPTY) {
+                if (has(r2, c2, Piece::RED_CANNON)) return true;
+                break;
+            }
+        }
+    }
+
+    // Knights: the leg is next to the knight, not next to the target.
+    for (const auto &[dr, dc] : KNIGHT_JUMPS) {
+        int kr = r - dr, kc = c - dc;
+        if (!has(kr, kc, Piece::RED_KNIGHT)) continue;
+        int leg_r = kr + (dr == 2 || dr == -2 ? dr / 2 : 0);
+        int leg_c = kc + (dc == 2 || dc == -2 ? dc / 2 : 0);
+        if (board.piece_at(leg_r, leg_c) == Piece::EMPTY) return true;
+    }
+
+    // Revealed advisors and elephants may leave their own half of the board.
+    for (const auto &[dr, dc] : DIAGONAL) {
+        if (has(r + dr, c + dc, Piece::RED_ADVISOR)) return true;
+        if (has(r + 2 * dr, c + 2 * dc, Piece::RED_BISHOP) &&
+            board.piece_at(r + dr, c + dc) == Piece::EMPTY)
+            return true;
+    }
+
+    // Pawns attack forwards, and sideways once they have crossed the river.
+    int forward_dir = (by == Color::RED) ? -1 : 1;
+    if (has(r - forward_dir, c, Piece::RED_PAWN)) return true;
+    bool crossed = (by == Color::RED) ? r <= 4 : r >= 5;
+    if (crossed && (has(r, c - 1, Piece::RED_PAWN) || has(r, c + 1, Piece::RED_PAWN))) return true;
+
+    return false;
+}
+
+bool MoveValidator::is_in_check(Color king_color, const Board &board) const {
+    int king_sq = board.king_square(king_color);
+    if (king_sq == NO_SQUARE) return true;  // King is captured, which is a game-ending state.
+    Color opponent_color = (king_color == Color::RED) ? Color::BLACK : Color::RED;
+    return is_square_attacked(king_sq, opponent_color, board);
+}
+
+bool MoveValidator::would_be_in_check_after_move(const Move &m, Color moving_color,
+                                                 Board &board) const {
+    Piece captured = board.make_move(m.from, m.to);
+    bool in_check = is_in_check(moving_color, board);
+    board.unmake_move(m.from, m.to, captured);
+    return in_check;
 }
 
 bool MoveValidator::is_move_legal(const std::string &move_str, Color moving_color,
                                   const Board &board) const {
     if (move_str.length() < 4) return false;
-    auto [r1, c1] = coord_to_pos(move_str.substr(0, 2));
-    auto [r2, c2] = coord_to_pos(move_str.substr(2, 2));
-    if (r1 == -1 || r2 == -1) return false;
-
-    Piece moving_piece = board[r1][c1];
-    if (moving_piece == Piece::EMPTY) return false;
+    Move m{parse_square(std::string_view(move_str).substr(0, 2)),
+           parse_square(std::string_view(move_str).substr(2, 2))};
+    if (m.from == NO_SQUARE || m.to == NO_SQUARE) return false;
 
     // Check if the piece being moved belongs to the current player
-    if (is_revealed(moving_piece)) {
-        if (get_piece_color(moving_piece) != moving_color) return false;
-    } else {  // Hidden piece
-        if (((r1 > 4) ? Color::RED : Color::BLACK) != moving_color) return false;
-    }
+    if (board.owner(m.from) != moving_color) return false;
 
-    if (!is_move_mechanically_valid(r1, c1, r2, c2, board)) {
+    if (!is_move_mechanically_valid(square_row(m.from), square_col(m.from), square_row(m.to),
+                                    square_col(m.to), board)) {
         return false;
     }
 
-    if (would_be_in_check_after_move(r1, c1, r2, c2, moving_color, board)) {
+    Board scratch = board;
+    if (would_be_in_check_after_move(m, moving_color, scratch)) {
         return false;
     }
 
     return true;
 }
 
-bool MoveValidator::is_checkmate_or_stalemate(Color player_to_move, const Board &board) const {
-    // Iterate over all pieces of the player
-    for (int r1 = 0; r1 < 10; ++r1) {
-        for (int c1 = 0; c1 < 9; ++c1) {
-            Piece p = board[r1][c1];
-            if (p == Piece::EMPTY) continue;
-
-            bool is_player_piece = false;
-            if (is_revealed(p)) {
-                if (get_piece_color(p) == player_to_move) is_player_piece = true;
-            } else {  // Hidden piece
-                if (((r1 > 4) ? Color::RED : Color::BLACK) == player_to_move)
-                    is_player_piece = true;
-            }
+bool MoveValidator::has_legal_move(Color player_to_move, const Board &board) const {
+    // Candidate moves are made and unmade on a single scratch copy.
+    Board scratch = board;
+    return visit_pseudo_legal_moves(player_to_move, board, [&](const Move &m) {
+        return !would_be_in_check_after_move(m, player_to_move, scratch);
+    });
+}
 
-            if (is_player_piece) {
-                // Check all possible moves for this piece
-                for (int r2 = 0; r2 < 10; ++r2) {
-                    for (int c2 = 0; c2 < 9; ++c2) {
-                        if (is_move_mechanically_valid(r1, c1, r2, c2, board)) {
-                            if (!would_be_in_check_after_move(r1, c1, r2, c2, player_to_move,
-                                                              board)) {
-                                // Found at least one legal move
-                                return false;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    // No legal moves found for any piece
-    return true;
-}
\ No newline at end of file
+MoveList MoveValidator::generate_legal_moves(Color player_to_move, const Board &board) const {
+    MoveList list;
+    Board scratch = board;
+    visit_pseudo_legal_moves(player_to_move, board, [&](const Move &m) {
+        if (!would_be_in_check_after_move(m, player_to_move, scratch)) list.push_back(m);
+        return false;
+    });
+    return list;
+}
+
+bool MoveValidator::is_checkmate_or_stalemate(Color player_to_move, const Board &board) const {
+    return !has_legal_move(player_to_move, board);
+}
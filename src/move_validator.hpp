@@ -1,13 +1,37 @@
 #pragma once
 
+#include <array>
 #include <optional>
 #include <string>
-#include <utility>
-#include <vector>
 
+#include "board.hpp"
 #include "types.hpp"
 
-using Board = std::vector<std::vector<Piece>>;
+// --- Moves ---
+
+struct Move {
+    int from = NO_SQUARE;
+    int to = NO_SQUARE;
+
+    // UCI notation, e.g. "h2e2".
+    std::string to_uci() const { return square_name(from) + square_name(to); }
+};
+
+// Fixed-capacity move list, so move generation never allocates.
+struct MoveList {
+    // Comfortably above the most moves any Jieqi position can have.
+    static constexpr int CAPACITY = 256;
+
+    std::array<Move, CAPACITY> moves;
+    int count = 0;
+
+    void push_back(Move m) { moves[count++] = m; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Move &operator[](int i) const { return moves[i]; }
+    const Move *begin() const { return moves.data(); }
+    const Move *end() const { return moves.data() + count; }
+};
 
 // --- Move Validation Logic ---
 // This class encapsulates all the rules for Jieqi move validation.
@@ -28,30 +52,40 @@ class MoveValidator {
     // Returns true if the player has no legal moves.
     bool is_checkmate_or_stalemate(Color player_to_move, const Board &board) const;
 
-   private:
-    // Helper to convert "a0" style coordinates to (row, col) pair.
-    static std::pair<int, int> coord_to_pos(const std::string &coord);
-    // Helper to get piece color.
-    static std::optional<Color> get_piece_color(Piece p);
-    // Helper to check if a piece is revealed.
-    static bool is_revealed(Piece p);
-    // Helper to get the fundamental type of a piece (e.g., RED_ROOK -> ROOK).
-    static Piece get_base_piece_type(Piece p);
+    // Returns true as soon as one legal move is found for the player.
+    bool has_legal_move(Color player_to_move, const Board &board) const;
 
+    // Generates every legal move for the player. Hidden pieces move according
+    // to the role of the square they stand on in the initial layout.
+    MoveList generate_legal_moves(Color player_to_move, const Board &board) const;
+
+    // The piece a hidden piece on `sq` moves as: the piece standing on that
+    // square in the initial layout.
+    static Piece hidden_role(int sq) { return initial_board_layout[sq]; }
+
+   private:
     // Checks if a move is mechanically valid, without considering check status.
     bool is_move_mechanically_valid(int r1, int c1, int r2, int c2, const Board &board) const;
 
-    // Simulates a move and checks if it would leave the king in check.
-    bool would_be_in_check_after_move(int r1, int c1, int r2, int c2, Color moving_color,
-                                      const Board &board) const;
+    // Calls visit(Move) for every pseudo-legal move of the player, i.e. moves
+    // that follow the piece rules but may leave the own king in check.
+    // Stops early and returns true as soon as visit() returns true.
+    template <typename Visitor>
+    bool visit_pseudo_legal_moves(Color side, const Board &board, Visitor &&visit) const;
+
+    // Makes a move in place, checks if it leaves the king in check, and
+    // unmakes it again.
+    bool would_be_in_check_after_move(const Move &m, Color moving_color, Board &board) const;
+
+    // Checks if a revealed piece of color `by` attacks `sq`. Works backwards
+    // from the target square, so only the few squares an attacker could stand
+    // on are inspected instead of every opposing piece.
+    bool is_square_attacked(int sq, Color by, const Board &board) const;
 
     // Counts pieces between two points on a straight line.
     int count_pieces_between(int r1, int c1, int r2, int c2, const Board &board) const;
 
-    // Finds the position of the specified king.
-    std::optional<std::pair<int, int>> find_king(Color king_color, const Board &board) const;
-
     // A static representation of the initial board layout to determine hidden
     // piece move rules.
-    static const Board initial_board_layout;
-};
\ No newline at end of file
+    static const std::array<Piece, BOARD_SQUARES> initial_board_layout;
+};
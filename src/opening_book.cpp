@@ -0,0 +1,195 @@
+#include "opening_book.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "random.hpp"
+
+namespace {
+
+// Layout of "<book>.idx": this header, then `count` 64-bit line offsets. The
+// book's size and modification time tell whether the index is still current.
+struct IndexHeader {
+    char magic[8];
+    std::uint64_t book_size;
+    std::uint64_t book_mtime;
+    std::uint64_t count;
+};
+
+constexpr char INDEX_MAGIC[8] = {'J', 'Q', 'B', 'K', 'I', 'D', 'X', '1'};
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Keyed bijection on [0, count): a four-round Feistel network on the smallest
+// even number of bits that covers `count`, applied again to values that fall
+// outside the range (cycle walking, fewer than four rounds on average).
+std::uint64_t permute(std::uint64_t index, std::uint64_t count, std::uint64_t key) {
+    int half_bits = 1;
+    while ((std::uint64_t{1} << (2 * half_bits)) < count) half_bits++;
+    const std::uint64_t mask = (std::uint64_t{1} << half_bits) - 1;
+
+    do {
+        std::uint64_t left = index >> half_bits;
+        std::uint64_t right = index & mask;
+        for (std::uint64_t round = 0; round < 4; ++round) {
+            std::uint64_t next = left ^ (mix64(right ^ key ^ (round << 56)) & mask);
+            left = right;
+            right = next;
+        }
+        index = (left << half_bits) | right;
+    } while (index >= count);
+    return index;
+}
+
+}  // namespace
+
+bool OpeningBook::open(const std::string &path, std::string &error) {
+    close();
+    if (!book.open(path)) {
+        error = "Could not open " + path;
+        return false;
+    }
+
+    if (book.size() >= sizeof(BookFileHeader) &&
+        std::memcmp(book.data(), BOOK_MAGIC, sizeof(BOOK_MAGIC)) == 0) {
+        return open_binary(path, error);
+    }
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    auto book_mtime = static_cast<std::uint64_t>(mtime.time_since_epoch().count());
+
+    std::string index_path = path + ".idx";
+    if (load_cached_index(index_path, book_mtime)) {
+        index_cached = true;
+    } else {
+        build_index();
+        index_saved = save_index(index_path, book_mtime);
+    }
+    return true;
+}
+
+bool OpeningBook::open_binary(const std::string &path, std::string &error) {
+    BookFileHeader header;
+    std::memcpy(&header, book.data(), sizeof(header));
+    size_t body = book.size() - sizeof(header);
+    if (header.record_size != sizeof(BookRecord) || body % sizeof(BookRecord) != 0) {
+        error = path + " is not a valid binary book (wrong record size or truncated)";
+        book.close();
+        return false;
+    }
+    // Records are 64 bytes and follow a 16-byte header in a page-aligned mapping.
+    records = {reinterpret_cast<const BookRecord *>(book.data() + sizeof(header)),
+               body / sizeof(BookRecord)};
+    return true;
+}
+
+void OpeningBook::close() {
+    offsets = {};
+    records = {};
+    built_index.clear();
+    built_index.shrink_to_fit();
+    cached_index.close();
+    book.close();
+    index_cached = false;
+    index_saved = false;
+}
+
+bool OpeningBook::load_cached_index(const std::string &index_path, std::uint64_t book_mtime) {
+    if (!cached_index.open(index_path)) return false;
+
+    IndexHeader header;
+    if (cached_index.size() < sizeof(header)) {
+        cached_index.close();
+        return false;
+    }
+    std::memcpy(&header, cached_index.data(), sizeof(header));
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        header.book_size != book.size() || header.book_mtime != book_mtime ||
+        header.count > cached_index.size() / sizeof(std::uint64_t) ||
+        cached_index.size() != sizeof(header) + header.count * sizeof(std::uint64_t)) {
+        cached_index.close();
+        return false;
+    }
+
+    // The mapping is page aligned and the header is a multiple of 8 bytes.
+    std::span<const std::uint64_t> cached = {
+        reinterpret_cast<const std::uint64_t *>(cached_index.data() + sizeof(header)),
+        static_cast<size_t>(header.count)};
+    // A damaged index with the right size must not send position() past the
+    // end of the book.
+    for (std::uint64_t offset : cached) {
+        if (offset >= book.size()) {
+            cached_index.close();
+            return false;
+        }
+    }
+    offsets = cached;
+    return true;
+}
+
+void OpeningBook::build_index() {
+    const char *data = book.data();
+    size_t size = book.size();
+    size_t start = 0;
+    while (start < size) {
+        const void *newline = std::memchr(data + start, '\n', size - start);
+        size_t end = newline ? static_cast<const char *>(newline) - data : size;
+
+        // Blank lines hold no position.
+        for (size_t i = start; i < end; ++i) {
+            if (!is_blank(data[i])) {
+                built_index.push_back(start);
+                break;
+            }
+        }
+        start = end + 1;
+    }
+    offsets = built_index;
+}
+
+bool OpeningBook::save_index(const std::string &index_path, std::uint64_t book_mtime) const {
+    IndexHeader header;
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.book_size = book.size();
+    header.book_mtime = book_mtime;
+    header.count = offsets.size();
+
+    // Written under a temporary name and renamed, so that a concurrent match
+    // never maps a half-written index.
+    std::string temp_path = index_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(offsets.data()),
+                  static_cast<std::streamsize>(offsets.size_bytes()));
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, index_path, ec);
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(temp_path, ignored);
+        return false;
+    }
+    return true;
+}
+
+std::string_view OpeningBook::position(size_t index) const {
+    std::string_view rest = book.view().substr(offsets[index]);
+    std::string_view line = rest.substr(0, rest.find('\n'));
+    while (!line.empty() && is_blank(line.front())) line.remove_prefix(1);
+    while (!line.empty() && is_blank(line.back())) line.remove_suffix(1);
+    return line;
+}
+
+size_t OpeningBook::opening_index(std::uint64_t round, std::uint64_t seed) const {
+    std::uint64_t count = size();
+    std::uint64_t pass = round / count;
+    return static_cast<size_t>(
+        permute(round % count, count, derive_key(seed, RandomStream::OPENINGS, pass)));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "book_format.hpp"
+#include "mapped_file.hpp"
+
+// --- Opening Book ---
+// A text book with one FEN per line, memory-mapped rather than read. The
+// start offset of every non-empty line is kept in an index, which is saved
+// next to the book as "<book>.idx" and mapped as well on the next match, so
+// opening a book of millions of positions costs neither time nor memory.
+// Binary books (see book_format.hpp) are recognized by their header and need
+// no index: their records have a fixed size.
+
+class OpeningBook {
+   private:
+    MappedFile book;
+    MappedFile cached_index;                  // Valid "<book>.idx", if there was one
+    std::vector<std::uint64_t> built_index;   // Index built at open() otherwise
+    std::span<const std::uint64_t> offsets;  // Start of each FEN line in `book`
+    std::span<const BookRecord> records;      // Positions of a binary book
+    bool index_cached = false;
+    bool index_saved = false;
+
+    bool open_binary(const std::string &path, std::string &error);
+    bool load_cached_index(const std::string &index_path, std::uint64_t book_mtime);
+    void build_index();
+    bool save_index(const std::string &index_path, std::uint64_t book_mtime) const;
+
+   public:
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+
+    // Maps the book at `path` and loads or builds its index. Returns false
+    // with `error` set if the book cannot be read or is a damaged binary book.
+    bool open(const std::string &path, std::string &error);
+    void close();
+
+    bool is_binary() const { return records.data() != nullptr; }
+    size_t size() const { return is_binary() ? records.size() : offsets.size(); }
+    bool empty() const { return size() == 0; }
+
+    // The FEN on the index-th non-empty line of a text book, pointing into
+    // the mapping.
+    std::string_view position(size_t index) const;
+    // The index-th position of a binary book.
+    const BookRecord &record(size_t index) const { return records[index]; }
+
+    // Index of the opening of round `round`. Each pass over the book visits
+    // every position once, in an order given by `seed` and the pass number,
+    // so the sequence is reproducible and any round can be looked up directly.
+    // The book must not be empty.
+    size_t opening_index(std::uint64_t round, std::uint64_t seed) const;
+
+    // Whether open() used the saved index, or saved the one it built.
+    bool used_cached_index() const { return index_cached; }
+    bool saved_index() const { return index_saved; }
+};
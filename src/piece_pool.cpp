@@ -1,90 +1,136 @@
 #include "piece_pool.hpp"
 
-#include <algorithm>
-#include <cctype>
 #include <iostream>
-#include <string>
-#include <vector>
 
-#include "types.hpp"
+#include "random.hpp"
+#include "zobrist.hpp"
 
-extern const std::map<char, Piece> char_to_piece;
-extern const std::map<Piece, char> piece_to_char;
+namespace {
 
-PiecePool::PiecePool() : rng(std::random_device{}()) {}
+// Pool pieces follow the king of their color in the Piece enum.
+constexpr int KING_OFFSET = 1;
+
+constexpr Piece pool_piece(int side, int kind) {
+    Color color = side == 0 ? Color::RED : Color::BLACK;
+    return make_piece(static_cast<Piece>(KING_OFFSET + kind), color);
+}
+
+// Side (0 Red, 1 Black) and kind of a pool piece, or -1 for the king, hidden
+// and empty.
+constexpr int side_of(Piece p) {
+    return piece_color(p) == Color::BLACK ? 1 : 0;
+}
+constexpr int kind_of(Piece p) {
+    if (!is_revealed(p)) return -1;
+    return static_cast<int>(base_piece_type(p)) - KING_OFFSET;
+}
+
+// Order of the pool string: rooks, advisors, cannons, knights, bishops and
+// pawns, Red before Black for each.
+constexpr std::array<int, PiecePool::KINDS> FEN_KIND_ORDER = {3, 0, 4, 2, 1, 5};
+
+static_assert(pool_piece(0, 0) == Piece::RED_ADVISOR && pool_piece(1, 5) == Piece::BLK_PAWN);
+static_assert(side_of(Piece::BLK_ROOK) == 1 && kind_of(Piece::BLK_ROOK) == 3);
+static_assert(kind_of(Piece::RED_KING) == -1 && kind_of(Piece::HIDDEN) == -1);
+
+}  // namespace
+
+void PiecePool::set_random_key(std::uint64_t key) {
+    random_key = key;
+    draws.fill(0);
+}
 
 // Initialize the pool from the FEN string part (e.g., "R2A2...n2b2")
 void PiecePool::from_string(std::string_view pool_str) {
-    counts.clear();
+    clear();
     if (pool_str.length() % 2 != 0) {
         std::cerr << "Warning: Malformed piece pool string: " << pool_str << std::endl;
         return;
     }
 
     for (size_t i = 0; i < pool_str.length(); i += 2) {
-        char piece_char = pool_str[i];
+        Piece piece = char_to_piece(pool_str[i]);
         char count_char = pool_str[i + 1];
 
-        if (char_to_piece.contains(piece_char) && isdigit(count_char)) {
-            counts[char_to_piece.at(piece_char)] = count_char - '0';
+        if (kind_of(piece) >= 0 && count_char >= '0' && count_char <= '9') {
+            set_count(piece, count_char - '0');
         } else {
-            std::cerr << "Warning: Skipping invalid entry in piece pool string: " << piece_char
+            std::cerr << "Warning: Skipping invalid entry in piece pool string: " << pool_str[i]
                       << count_char << std::endl;
         }
     }
 }
 
+void PiecePool::clear() {
+    for (auto &side : counts) side.fill(0);
+    totals.fill(0);
+    hash_key = 0;
+}
+
+void PiecePool::set_count(Piece piece, int count) {
+    int kind = kind_of(piece);
+    if (kind < 0) return;
+    int side = side_of(piece);
+    int &current = counts[side][kind];
+    hash_key ^= ZOBRIST.pool[static_cast<int>(piece)][current];
+    hash_key ^= ZOBRIST.pool[static_cast<int>(piece)][count];
+    totals[side] += count - current;
+    current = count;
+}
+
 // Generate the piece pool string in the new FEN format (mixed red and black
 // pieces)
 std::string PiecePool::to_string() const {
     std::string result;
-
-    // Define the order for mixed red and black pieces
-    std::vector<Piece> order = {Piece::RED_ROOK,    Piece::BLK_ROOK,   Piece::RED_ADVISOR,
-                                Piece::BLK_ADVISOR, Piece::RED_CANNON, Piece::BLK_CANNON,
-                                Piece::RED_KNIGHT,  Piece::BLK_KNIGHT, Piece::RED_BISHOP,
-                                Piece::BLK_BISHOP,  Piece::RED_PAWN,   Piece::BLK_PAWN};
-
-    for (const auto &piece : order) {
-        auto it = counts.find(piece);
-        if (it != counts.end() && it->second > 0) {
-            result += piece_to_char.at(piece);
-            result += std::to_string(it->second);
+    result.reserve(2 * 2 * KINDS);
+    for (int kind : FEN_KIND_ORDER) {
+        for (int side = 0; side < 2; ++side) {
+            int count = counts[side][kind];
+            if (count > 0) {
+                result += piece_to_char(pool_piece(side, kind));
+                result += static_cast<char>('0' + count);
+            }
         }
     }
-
     return result;
 }
 
 // Draws a random piece of a given color from the pool and decrements its count.
 std::optional<Piece> PiecePool::draw_random_piece(Color color) {
-    std::vector<Piece> available_pieces;
-    for (const auto &[piece, count] : counts) {
-        if (count > 0 && char_to_piece.contains(piece_to_char.at(piece))) {
-            bool is_red = isupper(piece_to_char.at(piece));
-            if ((color == Color::RED && is_red) || (color == Color::BLACK && !is_red)) {
-                for (int i = 0; i < count; ++i) {
-                    available_pieces.push_back(piece);
-                }
-            }
-        }
-    }
-
-    if (available_pieces.empty()) {
+    if (color == Color::NONE) return std::nullopt;
+    int side = color == Color::RED ? 0 : 1;
+    if (totals[side] == 0) {
         return std::nullopt;  // No pieces left for this color
     }
 
-    std::uniform_int_distribution<size_t> dist(0, available_pieces.size() - 1);
-    Piece drawn_piece = available_pieces[dist(rng)];
-
-    counts[drawn_piece]--;
+    // Each color has its own stream, so that one side's flips do not shift
+    // the other's.
+    std::uint64_t stream_key = random_key ^ mix64(static_cast<std::uint64_t>(side) + 1);
+    std::uint64_t random = counter_random(stream_key, draws[side]++);
+
+    // Pick the n-th remaining piece, counting kind by kind.
+    int pick = static_cast<int>(random_below(random, static_cast<std::uint32_t>(totals[side])));
+    int kind = 0;
+    while (pick >= counts[side][kind]) pick -= counts[side][kind++];
+
+    Piece drawn_piece = pool_piece(side, kind);
+    int &count = counts[side][kind];
+    hash_key ^= ZOBRIST.pool[static_cast<int>(drawn_piece)][count];
+    hash_key ^= ZOBRIST.pool[static_cast<int>(drawn_piece)][count - 1];
+    count--;
+    totals[side]--;
     return drawn_piece;
 }
 
 // For debugging or logging.
 void PiecePool::print_pool() const {
     std::cout << "Current Piece Pool:" << std::endl;
-    for (const auto &[piece, count] : counts) {
-        if (count > 0) std::cout << "  " << piece_to_char.at(piece) << ": " << count << std::endl;
+    for (int side = 0; side < 2; ++side) {
+        for (int kind = 0; kind < KINDS; ++kind) {
+            if (counts[side][kind] > 0) {
+                std::cout << "  " << piece_to_char(pool_piece(side, kind)) << ": "
+                          << counts[side][kind] << std::endl;
+            }
+        }
     }
-}
\ No newline at end of file
+}
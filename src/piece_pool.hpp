@@ -1,26 +1,46 @@
 #pragma once
 
-#include <map>
+#include <array>
+#include <cstdint>
 #include <optional>
-#include <random>
+#include <string>
 #include <string_view>
 
 #include "types.hpp"
 
 // --- Piece Pool ---
 
-// Manages the count of unrevealed pieces for both sides.
+// Manages the count of unrevealed pieces for both sides. Counts live in a
+// fixed table per color with a running total, so drawing a piece is one random
+// number and a scan over six entries, without allocating. The n-th draw of a
+// color uses the n-th value of a counter-based random stream, so the draws
+// are fully determined by the pool's random key.
 class PiecePool {
+   public:
+    // Kinds of piece a pool can hold: advisor, bishop, knight, rook, cannon, pawn.
+    static constexpr int KINDS = 6;
+
    private:
-    std::map<Piece, int> counts;
-    std::mt19937 rng;  // Mersenne Twister random number generator
+    std::array<std::array<int, KINDS>, 2> counts{};  // By color, then kind
+    std::array<int, 2> totals{};                     // Pieces left per color
+    std::uint64_t random_key = 0;
+    std::array<std::uint64_t, 2> draws{};  // Draws made per color, the stream counters
+    std::uint64_t hash_key = 0;  // Zobrist key of the pool contents
 
    public:
-    PiecePool();
+    PiecePool() = default;
+
+    // Sets the key of the draws and restarts their count.
+    void set_random_key(std::uint64_t key);
 
     // Initialize the pool from the FEN string part (e.g., "R2A2...n2b2")
     void from_string(std::string_view pool_str);
 
+    // Empties the pool, and sets the count of one piece (for loading a
+    // position without parsing its pool string).
+    void clear();
+    void set_count(Piece piece, int count);
+
     // Generate the piece pool string in the new FEN format (mixed red and black
     // pieces)
     std::string to_string() const;
@@ -29,6 +49,9 @@ class PiecePool {
     // count.
     std::optional<Piece> draw_random_piece(Color color);
 
+    // Zobrist key of the pool contents, maintained incrementally.
+    std::uint64_t key() const { return hash_key; }
+
     // For debugging or logging.
     void print_pool() const;
-};
\ No newline at end of file
+};
@@ -1,4 +1,148 @@
 #include "protocol.hpp"
 
-// Define the global mutex
-std::mutex g_gui_mutex;
\ No newline at end of file
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<GuiInfoMode> g_gui_info_mode(GuiInfoMode::PER_DEPTH);
+std::atomic<int> g_gui_info_interval_ms(100);
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How long search info may wait to be batched with later lines.
+constexpr auto INFO_TICK = std::chrono::milliseconds(5);
+
+struct OutputLine {
+    std::string text;
+    bool is_info = false;
+    int depth = -1;
+    int multipv = 1;
+};
+
+class GuiOutput {
+   private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<OutputLine> queue;
+    bool control_pending = false;  // A control message waits in the queue
+    bool stopping = false;
+
+    // Writer thread only
+    std::vector<OutputLine> batch;
+    std::string out;
+    OutputLine pending_info;  // Search info held back for coalescing
+    bool has_pending_info = false;
+    Clock::time_point last_info_write;
+
+    std::thread thread;  // Started last
+
+    void release_pending_info() {
+        if (!has_pending_info) return;
+        out += pending_info.text;
+        out += '\n';
+        has_pending_info = false;
+        last_info_write = Clock::now();
+    }
+
+    void hold_info(OutputLine &line) {
+        std::swap(pending_info, line);
+        has_pending_info = true;
+    }
+
+    void handle(OutputLine &line) {
+        if (!line.is_info) {
+            release_pending_info();
+            out += line.text;
+            out += '\n';
+            return;
+        }
+        switch (g_gui_info_mode.load(std::memory_order_relaxed)) {
+            case GuiInfoMode::ALL:
+                out += line.text;
+                out += '\n';
+                break;
+            case GuiInfoMode::PER_DEPTH:
+                // A line of another depth means the held one was the last of its depth.
+                if (has_pending_info && (pending_info.depth != line.depth ||
+                                         pending_info.multipv != line.multipv)) {
+                    release_pending_info();
+                }
+                hold_info(line);
+                break;
+            case GuiInfoMode::LATEST:
+                hold_info(line);
+                break;
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait_for(lock, INFO_TICK, [this] { return stopping || control_pending; });
+            bool done = stopping;
+            batch.swap(queue);
+            control_pending = false;
+            lock.unlock();
+
+            for (OutputLine &line : batch) handle(line);
+            batch.clear();
+            if (g_gui_info_mode.load(std::memory_order_relaxed) == GuiInfoMode::LATEST &&
+                Clock::now() - last_info_write >=
+                    std::chrono::milliseconds(g_gui_info_interval_ms.load())) {
+                release_pending_info();
+            }
+            if (done) release_pending_info();
+            if (!out.empty()) {
+                std::fwrite(out.data(), 1, out.size(), stdout);
+                std::fflush(stdout);
+                out.clear();
+            }
+
+            lock.lock();
+            if (done && queue.empty()) break;
+        }
+    }
+
+   public:
+    GuiOutput() : thread([this] { run(); }) {}
+
+    ~GuiOutput() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    void push(OutputLine line) {
+        bool is_control = !line.is_info;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(line));
+            if (is_control) control_pending = true;
+        }
+        // Search info waits for the next tick, so that bursts are written together.
+        if (is_control) wake.notify_one();
+    }
+};
+
+GuiOutput &gui_output() {
+    static GuiOutput output;
+    return output;
+}
+
+}  // namespace
+
+void send_to_gui(const std::string &message) {
+    gui_output().push({message, false});
+}
+
+void send_search_info(const std::string &line, int depth, int multipv) {
+    gui_output().push({line, true, depth, multipv});
+}
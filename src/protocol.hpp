@@ -1,19 +1,36 @@
 #pragma once
 
+#include <atomic>
 #include <format>
-#include <iostream>
-#include <mutex>
 #include <string>
 
-// Global mutex for thread-safe writing to stdout
-extern std::mutex g_gui_mutex;
+// --- GUI Output ---
+// Everything sent to the GUI goes through one output thread, which writes
+// queued lines in batches with a single flush instead of one flush per line.
+//
+// Control messages (moves, results, scores, option lists, ...) are written
+// in the order they were sent and without delay. Engine search info is
+// coalesced according to GuiInfoMode, since at fast time controls engines
+// print far more lines than a GUI can usefully show; pending search info is
+// always written before the next control message, so it never appears after
+// the move it belongs to.
 
-// Sends a message to the GUI in a thread-safe manner.
-// It automatically adds a newline and flushes the stream.
-inline void send_to_gui(const std::string &message) {
-    std::lock_guard<std::mutex> lock(g_gui_mutex);
-    std::cout << message << std::endl;
-}
+enum class GuiInfoMode {
+    ALL,        // Every line
+    PER_DEPTH,  // The last line of each depth
+    LATEST      // The latest line, at most once per g_gui_info_interval_ms
+};
+
+extern std::atomic<GuiInfoMode> g_gui_info_mode;
+extern std::atomic<int> g_gui_info_interval_ms;
+
+// Queues a control message for the GUI. A newline is added.
+void send_to_gui(const std::string &message);
+
+// Queues an engine search info line, subject to coalescing. `depth` and
+// `multipv` are the values parsed from the line (-1 if it has no depth);
+// lines are only merged with lines of the same depth and multipv.
+void send_search_info(const std::string &line, int depth, int multipv);
 
 // A helper to send formatted info strings
 inline void send_info_string(const std::string &message) {
@@ -23,4 +40,4 @@ inline void send_info_string(const std::string &message) {
 // A helper to send engine information
 inline void send_engine_info(const std::string &red_engine, const std::string &black_engine) {
     send_to_gui(std::format("info engine {} {}", red_engine, black_engine));
-}
\ No newline at end of file
+}
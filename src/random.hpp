@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// --- Counter-Based Random Numbers ---
+// Random values are computed from a key and a counter rather than drawn from
+// a generator with state, so any value of any stream can be reproduced on its
+// own, from any thread. Keys are derived from the match seed and what the
+// stream is for (e.g. the flips of game 17), which makes a whole match
+// reproducible from its seed.
+
+// SplitMix64 finalizer: a fast bijective mix of all 64 bits.
+constexpr std::uint64_t mix64(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Streams derived from the match seed.
+enum class RandomStream : std::uint64_t { OPENINGS = 1, FLIPS = 2 };
+
+// Key of the index-th stream of the given kind under `seed`.
+constexpr std::uint64_t derive_key(std::uint64_t seed, RandomStream stream,
+                                   std::uint64_t index) {
+    return mix64(mix64(mix64(seed) ^ static_cast<std::uint64_t>(stream)) ^ index);
+}
+
+// The counter-th random value of the stream with key `key`.
+constexpr std::uint64_t counter_random(std::uint64_t key, std::uint64_t counter) {
+    return mix64(key ^ mix64(counter + 0x9e3779b97f4a7c15ULL));
+}
+
+// Maps a random value to [0, bound) by multiplication; the bias is below
+// bound / 2^64.
+constexpr std::uint32_t random_below(std::uint64_t random, std::uint32_t bound) {
+    return static_cast<std::uint32_t>((static_cast<unsigned __int128>(random) * bound) >> 64);
+}
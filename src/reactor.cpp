@@ -0,0 +1,324 @@
+#include "reactor.hpp"
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine_pool.hpp"
+#include "game.hpp"
+#include "protocol.hpp"
+#include "tournament.hpp"
+
+extern std::atomic<bool> g_stop_match;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest time the reactor sleeps before checking whether the match was stopped.
+constexpr int STOP_CHECK_MS = 100;
+constexpr int MAX_EVENTS = 64;
+
+enum class SlotState {
+    WAIT_READY,  // Both engines were sent "isready"
+    SEARCHING,   // The engine to move is thinking
+    FINISHED     // No games left for this slot
+};
+
+// One concurrent game.
+struct Slot {
+    int id = 0;
+    SlotState state = SlotState::FINISHED;
+    GameTask task;
+    Engine *red = nullptr;
+    Engine *black = nullptr;
+    bool red_ready = false;
+    bool black_ready = false;
+    std::unique_ptr<Game> game;
+    Clock::time_point deadline;  // For the pending readyok or bestmove
+
+    bool is_primary() const { return id == 0; }
+};
+
+class Reactor {
+   private:
+    int epoll_fd;
+    EnginePool pool;
+    std::vector<Slot> slots;  // Never resized: epoll events point into it
+
+    void watch(Engine *engine, Slot &slot);
+    void unwatch(Engine *engine);
+
+    // Takes games from the queue until one has its engines starting up, or
+    // the queue is exhausted.
+    void start_next_game(Slot &slot);
+    // Starts the game once both engines answered "isready".
+    void begin_game(Slot &slot);
+    // Sends the next search, or finishes the game if it is over.
+    void begin_turn(Slot &slot);
+    // Scores the game, saves it and releases its engines.
+    void conclude_game(Slot &slot, Color result);
+    void finish_game(Slot &slot, Color result);
+
+    // Advances a slot after engine output or when its deadline passed.
+    void service(Slot &slot);
+    void service_wait_ready(Slot &slot);
+    void service_searching(Slot &slot);
+
+   public:
+    Reactor(int first_slot, int slot_count);
+    ~Reactor();
+
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+
+    void run();
+};
+
+Reactor::Reactor(int first_slot, int slot_count)
+    : epoll_fd(epoll_create1(EPOLL_CLOEXEC)), slots(slot_count) {
+    for (int i = 0; i < slot_count; ++i) {
+        slots[i].id = first_slot + i;
+    }
+}
+
+Reactor::~Reactor() {
+    pool.shutdown();
+    if (epoll_fd != -1) close(epoll_fd);
+}
+
+void Reactor::watch(Engine *engine, Slot &slot) {
+    int fd = engine->output_fd();
+    if (fd == -1) return;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &slot;
+    // A pooled engine may still be registered from its previous game.
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1 && errno == EEXIST) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+    }
+}
+
+void Reactor::unwatch(Engine *engine) {
+    // Idle engines are not watched; closed pipes leave the set on their own.
+    if (engine && engine->output_fd() != -1) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, engine->output_fd(), nullptr);
+    }
+}
+
+void Reactor::start_next_game(Slot &slot) {
+    while (true) {
+        slot.state = SlotState::FINISHED;
+        if (g_stop_match || !next_game_task(slot.id, slot.task)) {
+            return;
+        }
+        announce_game(slot.task, slot.id, slot.is_primary());
+
+        const GameTask &task = slot.task;
+        slot.red = pool.acquire(task.red_engine_path, task.red_engine_options,
+                                engine_cpus(task, slot.id, Color::RED), "Red", task.game_id,
+                                false);
+        if (!slot.red) {
+            send_info_string(std::format("[Game {}] Failed to start Red engine ({}). Black wins.",
+                                         task.game_id, task.red_engine_path));
+            conclude_game(slot, Color::BLACK);
+            continue;
+        }
+        slot.black = pool.acquire(task.black_engine_path, task.black_engine_options,
+                                  engine_cpus(task, slot.id, Color::BLACK), "Black",
+                                  task.game_id, false);
+        if (!slot.black) {
+            send_info_string(std::format("[Game {}] Failed to start Black engine ({}). Red wins.",
+                                         task.game_id, task.black_engine_path));
+            conclude_game(slot, Color::RED);
+            continue;
+        }
+
+        watch(slot.red, slot);
+        watch(slot.black, slot);
+        slot.red_ready = slot.black_ready = false;
+        slot.state = SlotState::WAIT_READY;
+        slot.deadline = Clock::now() + std::chrono::milliseconds(ENGINE_READY_TIMEOUT_MS);
+        return;
+    }
+}
+
+void Reactor::begin_game(Slot &slot) {
+    try {
+        slot.game = create_game(slot.task, *slot.red, *slot.black);
+        if (slot.is_primary()) {
+            send_to_gui(std::format("info fen {}", slot.game->get_initial_fen()));
+        }
+    } catch (const std::exception &e) {
+        send_info_string(std::format("[Game {}] Crashed with exception: {}. Game is a draw.",
+                                     slot.task.game_id, e.what()));
+        finish_game(slot, Color::NONE);
+        return;
+    }
+    begin_turn(slot);
+}
+
+void Reactor::begin_turn(Slot &slot) {
+    if (!slot.game->begin_turn(slot.is_primary())) {
+        finish_game(slot, slot.game->result());
+        return;
+    }
+    slot.state = SlotState::SEARCHING;
+    slot.deadline =
+        Clock::now() + std::chrono::milliseconds(slot.game->get_turn_deadline_ms());
+}
+
+void Reactor::conclude_game(Slot &slot, Color result) {
+    record_game_result(slot.task, result);
+    if (slot.game) {
+        report_game_stats(slot.task, *slot.game);
+        save_game_notation(slot.task, *slot.game, result);
+    }
+    for (Engine *engine : {slot.red, slot.black}) {
+        unwatch(engine);
+        pool.release(engine);
+    }
+    slot.red = slot.black = nullptr;
+    slot.game.reset();
+}
+
+void Reactor::finish_game(Slot &slot, Color result) {
+    conclude_game(slot, result);
+    start_next_game(slot);
+}
+
+void Reactor::service(Slot &slot) {
+    if (slot.state == SlotState::WAIT_READY) {
+        service_wait_ready(slot);
+    } else if (slot.state == SlotState::SEARCHING) {
+        service_searching(slot);
+    }
+}
+
+void Reactor::service_wait_ready(Slot &slot) {
+    bool expired = Clock::now() >= slot.deadline;
+    for (Color side : {Color::RED, Color::BLACK}) {
+        Engine *engine = side == Color::RED ? slot.red : slot.black;
+        bool &ready = side == Color::RED ? slot.red_ready : slot.black_ready;
+        Engine::PollResult status;
+        if (ready) {
+            status = engine->discard_output() ? Engine::PollResult::DONE
+                                              : Engine::PollResult::DIED;
+        } else {
+            status = engine->poll_ready();
+        }
+        if (status == Engine::PollResult::DONE) {
+            ready = true;
+            continue;
+        }
+        if (status == Engine::PollResult::PENDING) {
+            if (!expired) continue;
+            send_info_string(
+                std::format("Error: Engine {} did not answer isready.", engine->get_name()));
+            engine->kill();
+        }
+
+        bool red_failed = side == Color::RED;
+        send_info_string(std::format("[Game {}] Failed to start {} engine ({}). {} wins.",
+                                     slot.task.game_id, red_failed ? "Red" : "Black",
+                                     red_failed ? slot.task.red_engine_path
+                                                : slot.task.black_engine_path,
+                                     red_failed ? "Black" : "Red"));
+        finish_game(slot, red_failed ? Color::BLACK : Color::RED);
+        return;
+    }
+    if (slot.red_ready && slot.black_ready) {
+        begin_game(slot);
+    }
+}
+
+void Reactor::service_searching(Slot &slot) {
+    Engine &engine = slot.game->engine_to_move();
+    Engine *idle = (&engine == slot.red) ? slot.black : slot.red;
+    // An idle engine that dies is noticed on its next turn.
+    idle->discard_output();
+
+    std::string best_move;
+    if (engine.poll_search(slot.is_primary(), best_move) == Engine::PollResult::PENDING) {
+        if (Clock::now() < slot.deadline) return;
+        engine.abort_search();  // Flag fall: end_turn() scores it as a loss on time
+    }
+
+    if (slot.game->end_turn(best_move, slot.is_primary())) {
+        begin_turn(slot);
+    } else {
+        finish_game(slot, slot.game->result());
+    }
+}
+
+void Reactor::run() {
+    if (epoll_fd == -1) {
+        send_info_string("Error: Could not create the reactor's epoll instance.");
+        return;
+    }
+
+    for (auto &slot : slots) {
+        start_next_game(slot);
+    }
+
+    epoll_event events[MAX_EVENTS];
+    while (!g_stop_match) {
+        // Sleep until engine output arrives or the nearest deadline passes.
+        auto now = Clock::now();
+        auto wake = now + std::chrono::milliseconds(STOP_CHECK_MS);
+        bool active = false;
+        for (const auto &slot : slots) {
+            if (slot.state == SlotState::FINISHED) continue;
+            active = true;
+            wake = std::min(wake, slot.deadline);
+        }
+        if (!active) break;
+
+        auto timeout = std::chrono::ceil<std::chrono::milliseconds>(wake - now).count();
+        int count = epoll_wait(epoll_fd, events, MAX_EVENTS,
+                               static_cast<int>(std::max<long long>(timeout, 0)));
+        if (count < 0 && errno != EINTR) {
+            send_info_string("Error: epoll_wait failed, reactor stopped.");
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            service(*static_cast<Slot *>(events[i].data.ptr));
+        }
+        now = Clock::now();
+        for (auto &slot : slots) {
+            if (slot.state != SlotState::FINISHED && now >= slot.deadline) service(slot);
+        }
+    }
+}
+
+}  // namespace
+
+bool reactor_supported() {
+    return true;
+}
+
+void run_reactor(int first_slot, int slot_count) {
+    Reactor reactor(first_slot, slot_count);
+    reactor.run();
+}
+
+#else
+
+bool reactor_supported() {
+    return false;
+}
+
+void run_reactor(int, int) {}
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+// --- Reactor Scheduler ---
+// Alternative to one worker thread per game: a reactor thread drives many
+// games at once as state machines, waiting on the output pipes of all their
+// engines with a single epoll set. Engines are shared by the slots of a
+// reactor through one EnginePool. Linux only.
+
+// Whether the reactor scheduler is available on this platform.
+bool reactor_supported();
+
+// Plays games from the queue on `slot_count` concurrent game slots, numbered
+// from `first_slot` (slot 0 is the primary game), until the queue is empty or
+// the match is stopped.
+void run_reactor(int first_slot, int slot_count);
@@ -0,0 +1,128 @@
+#include "sprt.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numeric>
+
+namespace {
+
+// Average score per game of each pair outcome.
+constexpr std::array<double, 5> PAIR_SCORES = {0.0, 0.25, 0.5, 0.75, 1.0};
+
+// Added to every outcome before fitting, so that outcomes not seen yet do not
+// make the fitted distributions degenerate.
+constexpr double REGULARIZATION = 1e-3;
+
+double elo_to_score(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// The distribution closest to `observed` (in the maximum likelihood sense)
+// whose mean score is `mean` has the form observed[i] / (1 + lambda *
+// (score[i] - mean)). Returns that lambda, found by bisection: the mean of
+// the reweighted distribution falls as lambda grows.
+double fit_lambda(const std::array<double, 5> &observed, double mean) {
+    // Keep 1 + lambda * (score - mean) positive for scores 0 and 1.
+    double low = -1.0 / (1.0 - mean) + 1e-9;
+    double high = 1.0 / mean - 1e-9;
+    for (int i = 0; i < 100; ++i) {
+        double lambda = (low + high) / 2;
+        double excess = 0.0;
+        for (size_t k = 0; k < observed.size(); ++k) {
+            double d = PAIR_SCORES[k] - mean;
+            excess += observed[k] * d / (1.0 + lambda * d);
+        }
+        (excess > 0 ? low : high) = lambda;
+    }
+    return (low + high) / 2;
+}
+
+}  // namespace
+
+double score_to_elo(double score) {
+    score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+Sprt::Sprt(const SprtConfig &config) : config(config) {}
+
+void Sprt::add_pair(double engine1_points) {
+    int outcome = static_cast<int>(std::lround(engine1_points * 2));
+    counts[std::clamp(outcome, 0, 4)]++;
+}
+
+int Sprt::pairs() const {
+    return std::accumulate(counts.begin(), counts.end(), 0);
+}
+
+double Sprt::llr() const {
+    int n = pairs();
+    if (n == 0) return 0.0;
+
+    std::array<double, 5> observed{};
+    double total = n + REGULARIZATION * observed.size();
+    for (size_t k = 0; k < observed.size(); ++k) {
+        observed[k] = (counts[k] + REGULARIZATION) / total;
+    }
+
+    double s0 = elo_to_score(config.elo0);
+    double s1 = elo_to_score(config.elo1);
+    double lambda0 = fit_lambda(observed, s0);
+    double lambda1 = fit_lambda(observed, s1);
+
+    // Sum over the pairs of log(P1(outcome) / P0(outcome)).
+    double llr = 0.0;
+    for (size_t k = 0; k < observed.size(); ++k) {
+        llr += observed[k] * (std::log1p(lambda0 * (PAIR_SCORES[k] - s0)) -
+                              std::log1p(lambda1 * (PAIR_SCORES[k] - s1)));
+    }
+    return llr * n;
+}
+
+double Sprt::lower_bound() const {
+    return std::log(config.beta / (1.0 - config.alpha));
+}
+
+double Sprt::upper_bound() const {
+    return std::log((1.0 - config.beta) / config.alpha);
+}
+
+SprtResult Sprt::status() const {
+    double value = llr();
+    if (value >= upper_bound()) return SprtResult::ACCEPT_H1;
+    if (value <= lower_bound()) return SprtResult::ACCEPT_H0;
+    return SprtResult::CONTINUE;
+}
+
+double Sprt::elo() const {
+    int n = pairs();
+    if (n == 0) return 0.0;
+    double mean = 0.0;
+    for (size_t k = 0; k < counts.size(); ++k) mean += counts[k] * PAIR_SCORES[k];
+    return score_to_elo(mean / n);
+}
+
+double Sprt::elo_error() const {
+    int n = pairs();
+    if (n == 0) return 0.0;
+    double mean = 0.0;
+    for (size_t k = 0; k < counts.size(); ++k) mean += counts[k] * PAIR_SCORES[k];
+    mean /= n;
+    double variance = 0.0;
+    for (size_t k = 0; k < counts.size(); ++k) {
+        variance += counts[k] * (PAIR_SCORES[k] - mean) * (PAIR_SCORES[k] - mean);
+    }
+    variance /= n;
+
+    // 95% interval of the mean score per pair, converted to Elo.
+    double margin = 1.959964 * std::sqrt(variance / n);
+    return (score_to_elo(mean + margin) - score_to_elo(mean - margin)) / 2;
+}
+
+std::string Sprt::summary() const {
+    return std::format("LLR {:.2f} [{:.2f}, {:.2f}] Elo {:.1f} +/- {:.1f} pairs {} penta [{}, {}, "
+                       "{}, {}, {}]",
+                       llr(), lower_bound(), upper_bound(), elo(), elo_error(), pairs(),
+                       counts[0], counts[1], counts[2], counts[3], counts[4]);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+// --- SPRT ---
+// Sequential probability ratio test between H0 "engine1 is elo0 stronger"
+// and H1 "engine1 is elo1 stronger" (logistic Elo), so a match can stop as
+// soon as the result is decisive. Games are scored in pairs (both colors of
+// one opening), which cancels out most of the opening's bias: each pair ends
+// in one of five outcomes, from 0 to 2 points for engine1 (the pentanomial
+// model). The log-likelihood ratio is the generalized one, with the outcome
+// distributions under H0 and H1 fitted to the observed pairs by maximum
+// likelihood.
+
+struct SprtConfig {
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;  // Chance of accepting H1 when H0 holds
+    double beta = 0.05;   // Chance of accepting H0 when H1 holds
+};
+
+// Logistic Elo difference that gives an expected score of `score` (0 to 1).
+double score_to_elo(double score);
+
+enum class SprtResult { CONTINUE, ACCEPT_H0, ACCEPT_H1 };
+
+class Sprt {
+   public:
+    explicit Sprt(const SprtConfig &config = {});
+
+    // Adds a finished pair in which engine1 scored `engine1_points` (0 to 2).
+    void add_pair(double engine1_points);
+
+    double llr() const;
+    double lower_bound() const;  // H0 is accepted at or below this LLR
+    double upper_bound() const;  // H1 is accepted at or above this LLR
+    SprtResult status() const;
+
+    // Elo of engine1 and the half-width of its 95% confidence interval.
+    double elo() const;
+    double elo_error() const;
+
+    int pairs() const;
+
+    // "LLR x [lower, upper] Elo x +/- y pairs n penta [..]" for info strings.
+    std::string summary() const;
+
+   private:
+    SprtConfig config;
+    std::array<int, 5> counts{};  // Pairs by engine1's points: 0, 0.5, 1, 1.5, 2
+};
@@ -1,5 +1,6 @@
 #include "time_manager.hpp"
 
+#include <algorithm>
 #include <format>
 
 TimeManager::TimeManager(const TimeControl &initial_tc, int timeout_buffer_ms)
@@ -28,6 +29,10 @@ int TimeManager::get_time_ms(Color player) const {
     return player == Color::RED ? tc.wtime_ms : tc.btime_ms;
 }
 
+int TimeManager::get_deadline_ms(Color player) const {
+    return std::max(0, get_time_ms(player) + timeout_buffer_ms);
+}
+
 std::string TimeManager::get_go_command() const {
     return std::format("go wtime {} btime {} winc {} binc {}", tc.wtime_ms, tc.btime_ms, tc.winc_ms,
                        tc.binc_ms);
@@ -27,6 +27,9 @@ class TimeManager {
     void update(Color player_who_moved, long long elapsed_ms);
     bool is_out_of_time(Color player) const;
     int get_time_ms(Color player) const;
+    // How long the player may think before losing on time: the remaining
+    // clock plus the timeout buffer.
+    int get_deadline_ms(Color player) const;
     std::string get_go_command() const;
 
     // Setter for timeout buffer
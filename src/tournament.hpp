@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "book_format.hpp"
+#include "cpu_affinity.hpp"
+#include "game.hpp"
+#include "game_record.hpp"
+#include "types.hpp"
+
+// --- Tournament Bookkeeping ---
+// Shared by the game schedulers; defined in main.cpp next to the match state.
+
+struct GameTask {
+    int game_id;
+    std::string red_engine_path;
+    std::string black_engine_path;
+    std::string red_engine_options;
+    std::string black_engine_options;
+    std::string start_fen;
+    bool red_is_first;  // The first player of the pairing plays Red
+    std::optional<BookRecord> start_record = std::nullopt;  // Replaces start_fen for binary books
+    std::uint64_t flip_key = 0;  // Random key of the game's flips
+    int pairing = 0;             // Index into the tournament's pairings
+};
+
+// Takes the next game for worker (or reactor slot) `worker_id`; the two games
+// of a round go to the same worker. Returns false when no games are left.
+bool next_game_task(int worker_id, GameTask &task);
+
+// Takes back the game `worker_id` was due to play next, the second game of
+// its current round, when the worker leaves the match. Returns false if it
+// has none.
+bool take_unplayed_game(int worker_id, GameTask &task);
+
+// Sets up the game of `task` between the given engines. Throws
+// std::runtime_error if its FEN is malformed.
+std::unique_ptr<Game> create_game(const GameTask &task, Engine &red, Engine &black);
+
+// Reports the start of a game played on `worker_id`.
+void announce_game(const GameTask &task, int worker_id, bool is_primary);
+
+// Cores the engine playing `side` in `task` is pinned to when the game runs on
+// game slot `slot`. Empty when CpuAffinity is off.
+CpuSet engine_cpus(const GameTask &task, int slot, Color side);
+
+// Adds a finished game to the match score and reports the new standings.
+void record_game_result(const GameTask &task, Color result);
+
+// Reports the per-engine search statistics of a finished game.
+void report_game_stats(const GameTask &task, const Game &game);
+
+// Queues the notation of a finished game for the archive writer if
+// SaveNotation is enabled.
+void save_game_notation(const GameTask &task, const Game &game, Color result);
+
+// Queues a finished game's record for the archive writer if SaveNotation is
+// enabled.
+void save_game_record(GameRecord record);
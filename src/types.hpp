@@ -1,6 +1,6 @@
 #pragma once
 
-#include <map>
+#include <array>
 
 // --- Core Data Types ---
 
@@ -27,6 +27,70 @@ enum class Piece {
     EMPTY
 };
 
-// Maps to convert between char and Piece enum.
-extern const std::map<char, Piece> char_to_piece;
-extern const std::map<Piece, char> piece_to_char;
\ No newline at end of file
+// --- Piece Conversions ---
+// Plain lookup tables and arithmetic on the enum order above, usable at
+// compile time and cheap enough for every square of every FEN.
+
+// Revealed pieces of a color are in the same order, Black's 7 after Red's.
+constexpr int BLACK_PIECE_OFFSET = static_cast<int>(Piece::BLK_KING);
+
+// FEN letter of each piece, by enum value; EMPTY has none.
+constexpr std::array<char, 16> PIECE_CHARS = {'K', 'A', 'B', 'N', 'R', 'C', 'P', 'k',
+                                              'a', 'b', 'n', 'r', 'c', 'p', 'x', '\0'};
+
+namespace types_detail {
+constexpr std::array<Piece, 128> make_char_to_piece() {
+    std::array<Piece, 128> table{};
+    table.fill(Piece::EMPTY);
+    for (int p = 0; p < static_cast<int>(Piece::EMPTY); ++p) {
+        table[static_cast<unsigned char>(PIECE_CHARS[p])] = static_cast<Piece>(p);
+    }
+    table['X'] = Piece::HIDDEN;  // Some FENs write hidden Red pieces as 'X'
+    return table;
+}
+}  // namespace types_detail
+
+// Piece of each FEN letter, by ASCII code; EMPTY for anything else.
+constexpr std::array<Piece, 128> CHAR_TO_PIECE = types_detail::make_char_to_piece();
+
+// The piece of a FEN letter ('x' and 'X' both give HIDDEN), or EMPTY if `c`
+// is not a piece letter.
+constexpr Piece char_to_piece(char c) {
+    auto index = static_cast<unsigned char>(c);
+    return index < CHAR_TO_PIECE.size() ? CHAR_TO_PIECE[index] : Piece::EMPTY;
+}
+
+// The FEN letter of a piece other than EMPTY.
+constexpr char piece_to_char(Piece p) {
+    return PIECE_CHARS[static_cast<int>(p)];
+}
+
+// Owner of a revealed piece; NONE for hidden and empty squares, whose owner
+// depends on the square.
+constexpr Color piece_color(Piece p) {
+    if (p == Piece::HIDDEN || p == Piece::EMPTY) return Color::NONE;
+    return p < Piece::BLK_KING ? Color::RED : Color::BLACK;
+}
+
+constexpr bool is_revealed(Piece p) {
+    return p != Piece::HIDDEN && p != Piece::EMPTY;
+}
+
+// The Red piece of the same type, e.g. BLK_ROOK -> RED_ROOK; hidden and
+// empty are returned as they are.
+constexpr Piece base_piece_type(Piece p) {
+    if (p >= Piece::BLK_KING && p <= Piece::BLK_PAWN) {
+        return static_cast<Piece>(static_cast<int>(p) - BLACK_PIECE_OFFSET);
+    }
+    return p;
+}
+
+// The piece of `color` with the type of `red_type`, e.g. (RED_ROOK, BLACK) -> BLK_ROOK.
+constexpr Piece make_piece(Piece red_type, Color color) {
+    if (color != Color::BLACK) return red_type;
+    return static_cast<Piece>(static_cast<int>(red_type) + BLACK_PIECE_OFFSET);
+}
+
+static_assert(char_to_piece('n') == Piece::BLK_KNIGHT && char_to_piece('X') == Piece::HIDDEN);
+static_assert(char_to_piece('1') == Piece::EMPTY && piece_to_char(Piece::RED_CANNON) == 'C');
+static_assert(make_piece(base_piece_type(Piece::BLK_PAWN), Color::BLACK) == Piece::BLK_PAWN);
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "uci_info.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// Splits off the next space-separated token of `rest`.
+std::string_view next_token(std::string_view &rest) {
+    size_t start = 0;
+    while (start < rest.size() && is_space(rest[start])) start++;
+    size_t end = start;
+    while (end < rest.size() && !is_space(rest[end])) end++;
+    std::string_view token = rest.substr(start, end - start);
+    rest.remove_prefix(end);
+    return token;
+}
+
+// Parses the next token as a number. Returns false and leaves `value`
+// untouched if it is not one.
+template <typename T>
+bool read_number(std::string_view &rest, T &value) {
+    std::string_view token = next_token(rest);
+    T parsed;
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), parsed);
+    if (error != std::errc() || end != token.data() + token.size()) return false;
+    value = parsed;
+    return true;
+}
+
+// Trims surrounding whitespace.
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+    while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+}  // namespace
+
+int SearchInfo::score_cp() const {
+    if (score_type != ScoreType::MATE) return score;
+    int magnitude = std::max(0, 30000 - (score < 0 ? -score : score));
+    return score >= 0 ? magnitude : -magnitude;
+}
+
+void SearchInfo::update(const SearchInfo &newer) {
+    if (newer.depth >= 0) depth = newer.depth;
+    if (newer.seldepth >= 0) seldepth = newer.seldepth;
+    if (newer.multipv >= 0) multipv = newer.multipv;
+    if (newer.nodes >= 0) nodes = newer.nodes;
+    if (newer.nps >= 0) nps = newer.nps;
+    if (newer.time_ms >= 0) time_ms = newer.time_ms;
+    if (newer.hashfull >= 0) hashfull = newer.hashfull;
+    if (newer.score_type != ScoreType::NONE) {
+        score_type = newer.score_type;
+        score = newer.score;
+        bound = newer.bound;
+    }
+}
+
+bool parse_info_line(std::string_view line, SearchInfo &info) {
+    std::string_view rest = line;
+    if (next_token(rest) != "info") return false;
+
+    bool has_fields = false;
+    while (!rest.empty()) {
+        std::string_view key = next_token(rest);
+        if (key.empty()) break;
+
+        if (key == "string") {
+            break;  // Free text up to the end of the line
+        } else if (key == "pv") {
+            info.pv = trim(rest);
+            has_fields = true;
+            break;  // The principal variation runs to the end of the line
+        }
+
+        has_fields = true;
+        if (key == "depth") {
+            read_number(rest, info.depth);
+        } else if (key == "seldepth") {
+            read_number(rest, info.seldepth);
+        } else if (key == "multipv") {
+            read_number(rest, info.multipv);
+        } else if (key == "nodes") {
+            read_number(rest, info.nodes);
+        } else if (key == "nps") {
+            read_number(rest, info.nps);
+        } else if (key == "time") {
+            read_number(rest, info.time_ms);
+        } else if (key == "hashfull") {
+            read_number(rest, info.hashfull);
+        } else if (key == "score") {
+            std::string_view type = next_token(rest);
+            if ((type == "cp" || type == "mate") && read_number(rest, info.score)) {
+                info.score_type =
+                    type == "cp" ? SearchInfo::ScoreType::CP : SearchInfo::ScoreType::MATE;
+                info.bound = SearchInfo::Bound::EXACT;
+            }
+        } else if (key == "lowerbound") {
+            info.bound = SearchInfo::Bound::LOWER;
+        } else if (key == "upperbound") {
+            info.bound = SearchInfo::Bound::UPPER;
+        }
+        // Other keys (currmove, tbhits, wdl, ...) are skipped; their values
+        // are never mistaken for keys.
+    }
+    return has_fields;
+}
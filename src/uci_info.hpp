@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// --- UCI Info Parsing ---
+
+// Fields of a UCI "info" line. Numeric fields the line does not contain are -1.
+struct SearchInfo {
+    enum class ScoreType { NONE, CP, MATE };
+    enum class Bound { EXACT, LOWER, UPPER };
+
+    int depth = -1;
+    int seldepth = -1;
+    int multipv = -1;
+    std::int64_t nodes = -1;
+    std::int64_t nps = -1;
+    std::int64_t time_ms = -1;
+    int hashfull = -1;  // Permill
+    ScoreType score_type = ScoreType::NONE;
+    int score = 0;  // Centipawns, or moves to mate (negative if being mated)
+    Bound bound = Bound::EXACT;
+    std::string_view pv;  // Points into the parsed line; empty if none
+
+    // Score in centipawns, with mate scores encoded as +/-(30000 - moves).
+    // Only meaningful if score_type is not NONE.
+    int score_cp() const;
+
+    // Copies the fields present in `newer` over this one, to keep the latest
+    // known state of a search. The pv is not copied, as it would outlive its line.
+    void update(const SearchInfo &newer);
+};
+
+// Parses an "info" line in place, without allocating. Returns false if the
+// line is not an info line or only carries an "info string" message.
+bool parse_info_line(std::string_view line, SearchInfo &info);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "board.hpp"
+#include "types.hpp"
+
+// --- Zobrist Hashing ---
+// Random 64-bit keys for incremental position hashing. A position key is the
+// XOR of the keys of every (piece, square) on the board (hidden pieces
+// included), of every (pool piece, count) in the piece pool, and of the
+// side-to-move key when Black is to move.
+
+constexpr int ZOBRIST_PIECES = static_cast<int>(Piece::EMPTY);  // EMPTY has no key
+constexpr int ZOBRIST_MAX_POOL_COUNT = 9;  // Pool counts are single FEN digits
+
+struct ZobristKeys {
+    std::array<std::array<std::uint64_t, BOARD_SQUARES>, ZOBRIST_PIECES> piece_square{};
+    std::array<std::array<std::uint64_t, ZOBRIST_MAX_POOL_COUNT + 1>, ZOBRIST_PIECES> pool{};
+    std::uint64_t black_to_move = 0;
+};
+
+// Keys are generated at compile time from a fixed seed with SplitMix64, so
+// they are identical across runs and platforms.
+constexpr ZobristKeys make_zobrist_keys() {
+    std::uint64_t state = 0x4A49455149415245ULL;  // "JIEQIARE"
+    auto next = [&state]() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+
+    ZobristKeys keys;
+    for (auto &piece : keys.piece_square) {
+        for (auto &key : piece) key = next();
+    }
+    for (auto &piece : keys.pool) {
+        // A count of zero contributes nothing, so absent entries need no key.
+        for (int count = 1; count <= ZOBRIST_MAX_POOL_COUNT; ++count) piece[count] = next();
+    }
+    keys.black_to_move = next();
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = make_zobrist_keys();